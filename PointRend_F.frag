@@ -3,9 +3,9 @@
 layout( location = 0 ) out vec4 FragColor;
 layout( location = 1 ) out vec4 OutColor;
 
-uniform vec4 color;
+in vec4 quad_color;
 
 void main() {
     //OutColor = texture(Tex01, out_uv);
-    OutColor = color;
+    OutColor = quad_color;
 }
\ No newline at end of file
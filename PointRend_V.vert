@@ -1,10 +1,24 @@
 #version 430
 
-layout (location = 0) in vec3 VertexPosition;
+// x, y, packed rgb (r | g << 8 | b << 16, exact in a float), size scale
+layout (location = 0) in vec4 VertexPoint;
+// same point 1 frame later
+layout (location = 1) in vec4 NextPoint;
 
 uniform mat4 MV;
 uniform mat4 Proj;
+uniform float blend;  // playback position between the 2 frames (0 - 1)
+
+out vec4 point_color;
+out float point_scale;
 
 void main() {
-    gl_Position = MV * vec4(VertexPosition, 1.f);
+    // padding points (set ends before the next frame) aren't blended
+    vec2 pos = VertexPoint.xy;
+    if (NextPoint.w > 0.f) pos = mix(pos, NextPoint.xy, blend);
+    gl_Position = MV * vec4(pos, 0.f, 1.f);
+    uint rgb = uint(VertexPoint.z);
+    point_color = vec4(float(rgb & 0xFFu), float((rgb >> 8) & 0xFFu),
+                       float((rgb >> 16) & 0xFFu), 255.f) / 255.f;
+    point_scale = VertexPoint.w;
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 430
+
+layout( location = 0 ) out vec4 FragColor;
+layout( location = 1 ) out vec4 OutColor;
+
+in vec4 line_color;
+in float line_valid;
+
+void main() {
+    // segment touches a padding point
+    if (line_valid < 1.f) discard;
+    OutColor = line_color;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#version 430
+
+// x, y, packed rgb, size scale (same layout as the point pass)
+layout (location = 0) in vec4 VertexPoint;
+
+uniform mat4 MVP;
+uniform int block_points;   // points per frame block
+uniform int curr_frame;
+uniform int trail_frames;   // 0: whole sequence w/o fading
+uniform vec4 fade_color;    // trails fade into this (background)
+
+out vec4 line_color;
+out float line_valid;
+
+void main() {
+    gl_Position = MVP * vec4(VertexPoint.xy, 0.f, 1.f);
+    uint rgb = uint(VertexPoint.z);
+    vec4 color = vec4(float(rgb & 0xFFu), float((rgb >> 8) & 0xFFu),
+                      float((rgb >> 16) & 0xFFu), 255.f) / 255.f;
+
+    // indexed draw: gl_VertexID is the buffer index, so frame = id / block
+    float weight = 0.5f;
+    if (trail_frames > 0) {
+        int age = curr_frame - gl_VertexID / block_points;
+        weight = clamp(1.f - float(age) / float(trail_frames), 0.f, 1.f);
+    }
+    line_color = mix(fade_color, color, weight);
+    // padding points have size 0
+    line_valid = VertexPoint.w > 0.f ? 1.f : 0.f;
+}
\ No newline at end of file
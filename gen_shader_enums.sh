@@ -9,3 +9,7 @@
 	-v "./PointRend_V.vert" \
 	-g "./PointRend_G.geom" \
 	-f "./PointRend_F.frag"
+
+./../../bin/shader_reflect -o svis_shader_enums.h -a -e RE_Trajectory \
+	-v "./Trajectory_V.vert" \
+	-f "./Trajectory_F.frag"
@@ -0,0 +1,762 @@
+// Standalone benchmarks for smile_vis data & inference paths
+//
+// usage: smile_vis_bench [--suite] [--json out.json] [--compare base.json]
+//                        [--threshold pct] [weight dir] [bias dir]
+//                        [input csv] [ground csv] [corpus dir]
+// (defaults to the bundled weight/, bias/, input/28063_s_out.csv,
+//  ground_truth/28063_s_out.csv & all_data/)
+//
+// --suite     only run the regression suite (skip the comparisons vs the
+//             pre-optimization baselines)
+// --json      write suite results (1 case per line) for use as a baseline
+// --compare   print % deltas vs a file written by --json, exit code 2 if any
+//             case got slower than --threshold (default 10%)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include "ddFileIO.h"
+#include "smile_vis_canon.h"
+#include "smile_vis_data.h"
+#include "smile_vis_mlp.h"
+#include "smile_vis_mmap.h"
+#include "smile_vis_model.h"
+
+// heap allocations made by the whole process
+std::atomic<unsigned long> heap_allocs(0);
+std::atomic<unsigned long> heap_bytes(0);
+
+void count_alloc(const std::size_t size) {
+  heap_allocs.fetch_add(1, std::memory_order_relaxed);
+  heap_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+#if defined(__GLIBC__)
+// interpose the C allocator so Eigen's buffers (which bypass operator new)
+// are counted as well
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t num, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+
+void *malloc(std::size_t size) {
+  count_alloc(size);
+  return __libc_malloc(size);
+}
+void *calloc(std::size_t num, std::size_t size) {
+  count_alloc(num * size);
+  return __libc_calloc(num, size);
+}
+void *realloc(void *ptr, std::size_t size) {
+  count_alloc(size);
+  return __libc_realloc(ptr, size);
+}
+}
+#else
+// only C++ allocations are visible elsewhere
+void *operator new(std::size_t size) {
+  count_alloc(size);
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+namespace {
+typedef std::chrono::high_resolution_clock bench_clock;
+
+/** \brief Load w0..wN / b0..bN in layer order */
+bool load_model(const char *w_dir, const char *b_dir,
+                std::vector<Eigen::MatrixXd> &weights,
+                std::vector<Eigen::VectorXd> &biases) {
+  string512 w_file, b_file;
+  for (unsigned i = 0;; i++) {
+    w_file.format("%s/w%u.csv", w_dir, i);
+    b_file.format("%s/b%u.csv", b_dir, i);
+
+    ddIO probe;
+    if (!probe.open(w_file.str(), ddIOflag::READ)) break;
+
+    weights.push_back(extract_matrix(w_file.str()));
+    biases.push_back(extract_vector(b_file.str()));
+  }
+  return !weights.empty() && weights.size() == biases.size();
+}
+
+/** \brief Time `iters` calls of func & return average latency (ns) */
+template <typename F>
+double time_ns(const unsigned iters, F &&func) {
+  // warm up caches & branch predictors
+  for (unsigned i = 0; i < iters / 10 + 1; i++) func(i);
+
+  const bench_clock::time_point start = bench_clock::now();
+  for (unsigned i = 0; i < iters; i++) func(i);
+  const bench_clock::time_point end = bench_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / iters;
+}
+
+/** \brief Line by line ddIO + strtod parse (pre bulk parser baseline) */
+unsigned long legacy_parse(const char *in_file, const bool skip_header,
+                           std::vector<double> &out) {
+  ddIO io;
+  out.clear();
+  if (!io.open(in_file, ddIOflag::READ)) return 0;
+
+  unsigned long rows = 0;
+  const char *line = io.readNextLine();
+  if (skip_header) line = io.readNextLine();
+  while (line && *line) {
+    const char *curr = line;
+    while (*curr) {
+      char *nxt = nullptr;
+      const double val = std::strtod(curr, &nxt);
+      if (nxt == curr) break;
+      out.push_back(val);
+      curr = nxt;
+    }
+    line = io.readNextLine();
+    rows++;
+  }
+  return rows;
+}
+
+/** \brief Parse throughput of largest csv files vs line by line baseline */
+void bench_parse(const char *in_file, const char *w_dir) {
+  struct ParseCase {
+    string512 file;
+    VectorOut type;
+    bool matrix;
+  };
+  std::vector<ParseCase> cases;
+
+  // largest landmark file in the input folder & the largest weight layer
+  string512 dir = in_file;
+  dd_array<unsigned> token_idx = StrLib::tokenize(dir.str(), "\\/");
+  if (token_idx.size() > 0) {
+    char buff[512];
+    std::strncpy(buff, dir.str(), token_idx[token_idx.size() - 1]);
+    buff[token_idx[token_idx.size() - 1]] = '\0';
+    dir = buff;
+  }
+  const char *dirs[2] = {dir.str(), w_dir};
+  for (unsigned d = 0; d < 2; d++) {
+    ddIO folder;
+    if (!folder.open(dirs[d], ddIOflag::DIRECTORY)) continue;
+    dd_array<string512> files = folder.get_directory_files();
+    string512 largest;
+    FileStamp best, stamp;
+    DD_FOREACH(string512, file, files) {
+      if (!file.ptr->contains(".csv")) continue;
+      if (get_file_stamp(file.ptr->str(), stamp) && stamp.size > best.size) {
+        best = stamp;
+        largest = *file.ptr;
+      }
+    }
+    if (best.size > 0) {
+      ParseCase pc;
+      pc.file = largest;
+      pc.type = VectorOut::INPUT;
+      pc.matrix = d == 1;
+      cases.push_back(pc);
+    }
+  }
+
+  printf("\n[parse] bulk parser vs line by line ddIO + strtod\n");
+  std::vector<double> legacy_out;
+  for (size_t c = 0; c < cases.size(); c++) {
+    const char *file = cases[c].file.str();
+    FileStamp stamp;
+    get_file_stamp(file, stamp);
+
+    const unsigned iters = 200;
+    unsigned long rows = 0;
+    const double legacy_ns = time_ns(iters, [&](const unsigned) {
+      rows = legacy_parse(file, true, legacy_out);
+    });
+    const double bulk_ns = time_ns(iters, [&](const unsigned) {
+      if (cases[c].matrix) {
+        Eigen::MatrixXd m = extract_matrix(file);
+        rows = m.rows();
+      } else {
+        rows = extract_vector2(file, cases[c].type).size();
+      }
+    });
+
+    const double mb = stamp.size / (1024.0 * 1024.0);
+    printf("  %s (%.1f KB, %lu rows)\n", file, stamp.size / 1024.0, rows);
+    printf("    line by line: %8.1f MB/s %12.0f rows/s\n",
+           mb / (legacy_ns * 1e-9), rows / (legacy_ns * 1e-9));
+    printf("    bulk        : %8.1f MB/s %12.0f rows/s (%.2fx)\n",
+           mb / (bulk_ns * 1e-9), rows / (bulk_ns * 1e-9),
+           legacy_ns / bulk_ns);
+  }
+}
+
+/** \brief Corpus load: every column vs network inputs vs 1 landmark family */
+void bench_projection(const char *data_dir) {
+  static const char *family[] = {"Oral commisure (L) x", "Oral commisure (L) y",
+                                 "Oral commisure (R) x", "Oral commisure (R) y"};
+  const unsigned num_family = sizeof(family) / sizeof(family[0]);
+  static const char *columns[] = {
+      "Oral commisure (L) x",   "Oral commisure (L) y",
+      "Oral commisure (R) x",   "Oral commisure (R) y",
+      "Iris (M) x",             "Iris (M) y",
+      "Iris (L) x",             "Iris (L) y",
+      "Dental show (Top) x",    "Dental show (Top) y",
+      "Dental show (Bottom) x", "Dental show (Bottom) y"};
+  const unsigned num_columns = sizeof(columns) / sizeof(columns[0]);
+
+  ddIO folder;
+  if (!folder.open(data_dir, ddIOflag::DIRECTORY)) return;
+  dd_array<string512> files = folder.get_directory_files();
+
+  const unsigned iters = 20;
+  unsigned long rows = 0, full_cols = 0;
+  double sink = 0.0;
+  const double full_ns = time_ns(iters, [&](const unsigned) {
+    rows = 0;
+    DD_FOREACH(string512, file, files) {
+      FrameSeq seq = extract_vector2(file.ptr->str(), VectorOut::INPUT);
+      rows += seq.size();
+      full_cols = seq.cols();
+      if (!seq.empty()) sink += seq[0](0);
+    }
+  });
+  const double proj_ns = time_ns(iters, [&](const unsigned) {
+    DD_FOREACH(string512, file, files) {
+      FrameSeq seq = extract_columns(file.ptr->str(), columns, num_columns);
+      if (!seq.empty()) sink += seq[0](0);
+    }
+  });
+
+  const double family_ns = time_ns(iters, [&](const unsigned) {
+    DD_FOREACH(string512, file, files) {
+      FrameSeq seq = extract_columns(file.ptr->str(), family, num_family);
+      if (!seq.empty()) sink += seq[0](0);
+    }
+  });
+
+  printf("\n[projection] %s: %lu rows, %lu columns\n", data_dir, rows,
+         full_cols);
+  printf("  all columns         : %10.2f ms\n", full_ns * 1e-6);
+  printf("  network inputs (%2u) : %10.2f ms (%.2fx)\n", num_columns,
+         proj_ns * 1e-6, full_ns / proj_ns);
+  printf("  oral commisure (%2u) : %10.2f ms (%.2fx, sink %g)\n", num_family,
+         family_ns * 1e-6, full_ns / family_ns, sink);
+}
+
+/** \brief Per frame translate/rotate/scale/translate (pre batch baseline) */
+void legacy_canonical_frame(glm::vec2 *input, const unsigned num_input,
+                            glm::vec2 *ground, const unsigned num_ground,
+                            const unsigned pf_r_l, const unsigned pf_l_l) {
+  const glm::vec2 delta_pos = -ground[pf_r_l];
+  for (unsigned i = 0; i < num_input; i++) input[i] += delta_pos;
+  for (unsigned i = 0; i < num_ground; i++) ground[i] += delta_pos;
+
+  const float rot_offset = atan2(ground[pf_l_l].y, ground[pf_l_l].x);
+  glm::mat2 r_mat;
+  r_mat[0][0] = glm::cos(-rot_offset);
+  r_mat[0][1] = glm::sin(-rot_offset);
+  r_mat[1][0] = -glm::sin(-rot_offset);
+  r_mat[1][1] = glm::cos(-rot_offset);
+  for (unsigned i = 0; i < num_input; i++) input[i] = r_mat * input[i];
+  for (unsigned i = 0; i < num_ground; i++) ground[i] = r_mat * ground[i];
+
+  const float scale = 1.f / glm::distance(ground[pf_r_l], ground[pf_l_l]);
+  glm::mat2 s_mat;
+  s_mat[0][0] = s_mat[1][1] = scale;
+  s_mat[0][1] = s_mat[1][0] = 0.f;
+  for (unsigned i = 0; i < num_input; i++) input[i] = s_mat * input[i];
+  for (unsigned i = 0; i < num_ground; i++) ground[i] = s_mat * ground[i];
+
+  const glm::vec2 pos(-0.5f, 0.f);
+  for (unsigned i = 0; i < num_input; i++) input[i] += pos;
+  for (unsigned i = 0; i < num_ground; i++) ground[i] += pos;
+}
+
+/** \brief Canonical transform of a sequence: per frame chain vs batched */
+void bench_canonical(const FrameSeq &input, const FrameSeq &ground) {
+  const unsigned pf_r_l =
+      find_key(VectorOut::OUTPUT, "Palpebral fissure (RL) x") / 2;
+  const unsigned pf_l_l =
+      find_key(VectorOut::OUTPUT, "Palpebral fissure (LL) x") / 2;
+  const unsigned frames = std::min(input.size(), ground.size());
+  if (frames == 0 || pf_r_l >= ground.cols() / 2) return;
+
+  const unsigned iters = 2000;
+  std::vector<glm::vec2> in_p(input.cols() / 2), g_p(ground.cols() / 2);
+  double sink = 0.0;
+  const double legacy_ns = time_ns(iters, [&](const unsigned) {
+    for (unsigned f = 0; f < frames; f++) {
+      for (unsigned p = 0; p < in_p.size(); p++) {
+        in_p[p] = glm::vec2(input[f](p * 2), input[f](p * 2 + 1));
+      }
+      for (unsigned p = 0; p < g_p.size(); p++) {
+        g_p[p] = glm::vec2(ground[f](p * 2), ground[f](p * 2 + 1));
+      }
+      legacy_canonical_frame(in_p.data(), in_p.size(), g_p.data(), g_p.size(),
+                             pf_r_l, pf_l_l);
+      sink += in_p[0].x;
+    }
+  });
+
+  PointSeq in_seq, g_seq;
+  CanonTransforms xforms;
+  const double batch_ns = time_ns(iters, [&](const unsigned) {
+    to_point_seq(input.matrix().topRows(frames), in_seq);
+    to_point_seq(ground.matrix().topRows(frames), g_seq);
+    canonicalize_sequence(in_seq, g_seq, glm::vec2(-0.5f, 0.f), 1.f, xforms);
+    sink += in_seq.x[0];
+  });
+
+  // transform only (points already in SoA layout)
+  to_point_seq(ground.matrix().topRows(frames), g_seq);
+  const double xform_ns = time_ns(iters, [&](const unsigned) {
+    canonical_transforms(g_seq, pf_r_l, pf_l_l, glm::vec2(-0.5f, 0.f), 1.f,
+                         xforms);
+    apply_transforms(xforms, g_seq);
+    sink += g_seq.x[0];
+  });
+
+  printf("\n[canonical] %u frames (%u iterations)\n", frames, iters);
+  printf("  per frame glm chain : %10.1f ns/frame\n", legacy_ns / frames);
+  printf("  batched incl. SoA   : %10.1f ns/frame (%.2fx)\n",
+         batch_ns / frames, legacy_ns / batch_ns);
+  printf("  batched ground only : %10.1f ns/frame (sink %g)\n",
+         xform_ns / frames, sink);
+}
+
+void bench_single_sample(const FrameSeq &frames,
+                         std::vector<Eigen::MatrixXd> &weights,
+                         std::vector<Eigen::VectorXd> &biases) {
+  const unsigned iters = 20000;
+  const unsigned n = frames.size();
+
+  // accumulate outputs so the compiler can't drop the work
+  double sink = 0.0;
+
+  const double ff_ns = time_ns(iters, [&](const unsigned i) {
+    std::vector<double> out = feedForward(frames[i % n], weights, biases);
+    sink += out[0];
+  });
+
+  SmileMLP *fixed_mlp = new SmileMLP();
+  MLPEvaluator<> dyn_mlp;
+  double out[SmileMLP::out_size];
+  double fixed_ns = 0.0, dyn_ns = 0.0, fixed_diff = 0.0, dyn_diff = 0.0;
+
+  // sanity check evaluator against reference implementation
+  auto max_diff = [&](auto &mlp) {
+    double diff = 0.0;
+    for (unsigned i = 0; i < n; i++) {
+      std::vector<double> ref = feedForward(frames[i], weights, biases);
+      mlp.eval(frames[i].data(), out);
+      for (unsigned j = 0; j < ref.size(); j++) {
+        diff = std::max(diff, std::abs(ref[j] - out[j]));
+      }
+    }
+    return diff;
+  };
+
+  if (fixed_mlp->load(weights, biases)) {
+    fixed_ns = time_ns(iters, [&](const unsigned i) {
+      fixed_mlp->eval(frames[i % n].data(), out);
+      sink += out[0];
+    });
+    fixed_diff = max_diff(*fixed_mlp);
+  }
+  if (dyn_mlp.load(weights, biases)) {
+    dyn_ns = time_ns(iters, [&](const unsigned i) {
+      dyn_mlp.eval(frames[i % n].data(), out);
+      sink += out[0];
+    });
+    dyn_diff = max_diff(dyn_mlp);
+  }
+  delete fixed_mlp;
+
+  printf("\n[mlp] single sample latency (%u iterations)\n", iters);
+  printf("  feedForward           : %10.1f ns\n", ff_ns);
+  if (fixed_ns > 0.0) {
+    printf("  MLPEvaluator<12..34>  : %10.1f ns (%.2fx, max |diff| %g)\n",
+           fixed_ns, ff_ns / fixed_ns, fixed_diff);
+  } else {
+    printf("  MLPEvaluator<12..34>  : model shape mismatch, skipped\n");
+  }
+  if (dyn_ns > 0.0) {
+    printf("  MLPEvaluator<>        : %10.1f ns (%.2fx, max |diff| %g)\n",
+           dyn_ns, ff_ns / dyn_ns, dyn_diff);
+  }
+  printf("  (sink %g)\n", sink);
+}
+/** \brief Result of 1 suite case */
+struct SuiteResult {
+  string64 name;
+  unsigned iters = 0;
+  double ns_per_call = 0.0;
+  double rows_per_s = 0.0;
+  double bytes_per_s = 0.0;
+  double allocs_per_call = 0.0;
+  double alloc_bytes_per_call = 0.0;
+};
+
+/**
+ * \brief Time func & count its heap allocations
+ * \param rows, bytes Work done by 1 call (frames/samples & input bytes)
+ */
+template <typename F>
+SuiteResult run_case(const char *name, const unsigned iters,
+                     const double rows, const double bytes, F &&func) {
+  SuiteResult res;
+  res.name = name;
+  res.iters = iters;
+
+  // warm up outside of the allocation window
+  for (unsigned i = 0; i < iters / 10 + 1; i++) func(i);
+
+  const unsigned long allocs = heap_allocs;
+  const unsigned long alloc_bytes = heap_bytes;
+  const bench_clock::time_point start = bench_clock::now();
+  for (unsigned i = 0; i < iters; i++) func(i);
+  const bench_clock::time_point end = bench_clock::now();
+
+  res.ns_per_call =
+      std::chrono::duration<double, std::nano>(end - start).count() / iters;
+  res.rows_per_s = rows / (res.ns_per_call * 1e-9);
+  res.bytes_per_s = bytes / (res.ns_per_call * 1e-9);
+  res.allocs_per_call = (double)(heap_allocs - allocs) / iters;
+  res.alloc_bytes_per_call = (double)(heap_bytes - alloc_bytes) / iters;
+  return res;
+}
+
+/** \brief Largest .csv in directory (empty if none) */
+string512 largest_csv(const char *dir) {
+  string512 largest;
+  ddIO folder;
+  if (!folder.open(dir, ddIOflag::DIRECTORY)) return largest;
+  dd_array<string512> files = folder.get_directory_files();
+  FileStamp best, stamp;
+  DD_FOREACH(string512, file, files) {
+    if (!file.ptr->contains(".csv")) continue;
+    if (get_file_stamp(file.ptr->str(), stamp) && stamp.size > best.size) {
+      best = stamp;
+      largest = *file.ptr;
+    }
+  }
+  return largest;
+}
+
+/** \brief Per function latency, throughput & allocations */
+std::vector<SuiteResult> run_suite(const char *w_dir, const char *in_file,
+                                   const char *g_file, const char *data_dir,
+                                   std::vector<Eigen::MatrixXd> &weights,
+                                   std::vector<Eigen::VectorXd> &biases) {
+  std::vector<SuiteResult> results;
+  double sink = 0.0;
+  FileStamp stamp;
+
+  // parsing
+  const FrameSeq input = extract_vector2(in_file, VectorOut::INPUT);
+  const FrameSeq ground = extract_vector2(g_file, VectorOut::OUTPUT);
+  get_file_stamp(in_file, stamp);
+  results.push_back(run_case("extract_vector2/input", 500, input.size(),
+                             stamp.size, [&](const unsigned) {
+                               sink += extract_vector2(in_file,
+                                                       VectorOut::INPUT)
+                                           .size();
+                             }));
+
+  const string512 corpus_file = largest_csv(data_dir);
+  if (corpus_file.str()[0] != '\0') {
+    get_file_stamp(corpus_file.str(), stamp);
+    const unsigned rows =
+        extract_vector2(corpus_file.str(), VectorOut::INPUT).size();
+    results.push_back(run_case("extract_vector2/all_data", 50, rows,
+                               stamp.size, [&](const unsigned) {
+                                 sink += extract_vector2(corpus_file.str(),
+                                                         VectorOut::INPUT)
+                                             .size();
+                               }));
+  }
+
+  const string512 weight_file = largest_csv(w_dir);
+  if (weight_file.str()[0] != '\0') {
+    get_file_stamp(weight_file.str(), stamp);
+    const Eigen::MatrixXd w = extract_matrix(weight_file.str());
+    results.push_back(run_case("extract_matrix", 200, w.rows(), stamp.size,
+                               [&](const unsigned) {
+                                 sink += extract_matrix(weight_file.str())
+                                             .rows();
+                               }));
+  }
+
+  // inference
+  const unsigned n = input.size();
+  if (n > 0) {
+    results.push_back(run_case(
+        "feedForward", 20000, 1, input.cols() * sizeof(double),
+        [&](const unsigned i) {
+          sink += feedForward(input[i % n], weights, biases)[0];
+        }));
+
+    // evaluators must stay allocation free (allocs_per_call == 0)
+    double mlp_out[SmileMLP::out_size];
+    std::unique_ptr<SmileMLP> fixed_mlp(new SmileMLP());
+    if (fixed_mlp->load(weights, biases)) {
+      results.push_back(run_case(
+          "MLPEvaluator<12..34>", 20000, 1, input.cols() * sizeof(double),
+          [&](const unsigned i) {
+            fixed_mlp->eval(input.row_data(i % n), mlp_out);
+            sink += mlp_out[0];
+          }));
+    }
+    MLPEvaluator<> dyn_mlp;
+    if (dyn_mlp.load(weights, biases) &&
+        dyn_mlp.output_size() <= (unsigned)SmileMLP::out_size) {
+      results.push_back(run_case(
+          "MLPEvaluator<>", 20000, 1, input.cols() * sizeof(double),
+          [&](const unsigned i) {
+            dyn_mlp.eval(input.row_data(i % n), mlp_out);
+            sink += mlp_out[0];
+          }));
+    }
+
+    RowMatrixXd out;
+    results.push_back(run_case(
+        "feedForward_batch", 500, n,
+        (double)n * input.cols() * sizeof(double), [&](const unsigned) {
+          feedForward_batch(input, weights, biases, out);
+          sink += out(0, 0);
+        }));
+
+    // 4 models sharing 1 pass (e.g. checkpoints compared in the viewer)
+    ModelLayers layers;
+    layers.weights = weights;
+    layers.biases = biases;
+    const std::vector<const ModelLayers *> batch(4, &layers);
+    std::vector<RowMatrixXd> outs;
+    results.push_back(run_case(
+        "feedForward_models/4", 500, n,
+        (double)n * input.cols() * sizeof(double), [&](const unsigned) {
+          feedForward_models(input, batch, outs);
+          sink += outs[3](0, 0);
+        }));
+  }
+
+  // conversion
+  dd_array<glm::vec3> points;
+  if (n > 0) {
+    results.push_back(run_case(
+        "get_points", 100000, 1, input.cols() * sizeof(double),
+        [&](const unsigned i) {
+          get_points(input, points, i % n, VectorOut::INPUT);
+          sink += points[0].x;
+        }));
+  }
+
+  // canonicalization
+  const unsigned frames = std::min(input.size(), ground.size());
+  if (frames > 0) {
+    PointSeq in_seq, g_seq;
+    CanonTransforms xforms;
+    results.push_back(run_case(
+        "canonicalize_sequence", 2000, frames,
+        (double)frames * (input.cols() + ground.cols()) * sizeof(double),
+        [&](const unsigned) {
+          to_point_seq(input.matrix().topRows(frames), in_seq);
+          to_point_seq(ground.matrix().topRows(frames), g_seq);
+          canonicalize_sequence(in_seq, g_seq, glm::vec2(-0.5f, 0.f), 1.f,
+                                xforms);
+          sink += in_seq.x[0];
+        }));
+
+    // 1 frame export into a scratch folder (appends 1 row per call)
+    const char *tmp_dir = "bench_tmp";
+    if (make_directory(tmp_dir)) {
+      dd_array<glm::vec3> in_p, g_p;
+      get_points(input, in_p, 0, VectorOut::INPUT);
+      get_points(ground, g_p, 0, VectorOut::OUTPUT);
+      results.push_back(run_case(
+          "export_canonical_data", 2000, 1,
+          (in_p.size() + g_p.size()) * 2 * sizeof(float),
+          [&](const unsigned i) {
+            export_canonical_data(in_p, g_p, tmp_dir, tmp_dir,
+                                  "bench00_out.csv", glm::vec2(-0.5f, 0.f),
+                                  1.f, i > 0);
+          }));
+      // both outputs land in <dir>/<1st 7 chars of id>_canon.csv
+      string512 out_file;
+      out_file.format("%s/bench00_canon.csv", tmp_dir);
+      std::remove(out_file.str());
+    }
+  }
+
+  if (sink == 0.123) printf("sink %g\n", sink);
+  return results;
+}
+
+void print_suite(const std::vector<SuiteResult> &results) {
+  printf("\n[suite] %-24s %12s %12s %10s %10s %12s\n", "case", "ns/call",
+         "rows/s", "MB/s", "allocs", "alloc KB");
+  for (size_t r = 0; r < results.size(); r++) {
+    const SuiteResult &res = results[r];
+    printf("        %-24s %12.1f %12.0f %10.1f %10.1f %12.2f\n",
+           res.name.str(), res.ns_per_call, res.rows_per_s,
+           res.bytes_per_s / (1024.0 * 1024.0), res.allocs_per_call,
+           res.alloc_bytes_per_call / 1024.0);
+  }
+}
+
+bool write_suite_json(const char *file,
+                      const std::vector<SuiteResult> &results) {
+  FILE *out = fopen(file, "w");
+  if (!out) return false;
+  fprintf(out, "{\n  \"cases\": [\n");
+  for (size_t r = 0; r < results.size(); r++) {
+    const SuiteResult &res = results[r];
+    fprintf(out,
+            "    {\"name\": \"%s\", \"iters\": %u, \"ns_per_call\": %.3f, "
+            "\"rows_per_s\": %.1f, \"bytes_per_s\": %.1f, "
+            "\"allocs_per_call\": %.3f, \"alloc_bytes_per_call\": %.1f}%s\n",
+            res.name.str(), res.iters, res.ns_per_call, res.rows_per_s,
+            res.bytes_per_s, res.allocs_per_call, res.alloc_bytes_per_call,
+            r + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "  ]\n}\n");
+  fclose(out);
+  return true;
+}
+
+/** \brief Read cases of a file written by write_suite_json */
+bool read_suite_json(const char *file, std::vector<SuiteResult> &results) {
+  FILE *in = fopen(file, "r");
+  if (!in) return false;
+  char line[1024];
+  while (fgets(line, sizeof(line), in)) {
+    const char *name = strstr(line, "\"name\": \"");
+    if (!name) continue;
+    SuiteResult res;
+    char buff[64] = {};
+    if (sscanf(name,
+               "\"name\": \"%63[^\"]\", \"iters\": %u, \"ns_per_call\": %lf, "
+               "\"rows_per_s\": %lf, \"bytes_per_s\": %lf, "
+               "\"allocs_per_call\": %lf, \"alloc_bytes_per_call\": %lf",
+               buff, &res.iters, &res.ns_per_call, &res.rows_per_s,
+               &res.bytes_per_s, &res.allocs_per_call,
+               &res.alloc_bytes_per_call) == 7) {
+      res.name = buff;
+      results.push_back(res);
+    }
+  }
+  fclose(in);
+  return true;
+}
+
+/** \brief Print % deltas vs baseline (returns # of regressed cases) */
+unsigned compare_suite(const std::vector<SuiteResult> &results,
+                       const std::vector<SuiteResult> &baseline,
+                       const double threshold) {
+  unsigned regressions = 0;
+  printf("\n[compare] %-24s %12s %12s %9s %10s\n", "case", "base ns",
+         "ns/call", "delta", "allocs");
+  for (size_t r = 0; r < results.size(); r++) {
+    const SuiteResult &res = results[r];
+    const SuiteResult *base = nullptr;
+    for (size_t b = 0; b < baseline.size(); b++) {
+      if (baseline[b].name == res.name) base = &baseline[b];
+    }
+    if (!base) {
+      printf("          %-24s %12s %12.1f %9s\n", res.name.str(), "-",
+             res.ns_per_call, "new");
+      continue;
+    }
+
+    // + is slower
+    const double delta =
+        (res.ns_per_call - base->ns_per_call) / base->ns_per_call * 100.0;
+    const bool regressed = delta > threshold;
+    regressions += regressed ? 1 : 0;
+    printf("          %-24s %12.1f %12.1f %+8.1f%% %+10.1f%s\n",
+           res.name.str(), base->ns_per_call, res.ns_per_call, delta,
+           res.allocs_per_call - base->allocs_per_call,
+           regressed ? "  REGRESSION" : "");
+  }
+  return regressions;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  // flags first, remaining arguments are positional
+  bool suite_only = false;
+  const char *json_file = nullptr;
+  const char *base_file = nullptr;
+  double threshold = 10.0;
+  std::vector<const char *> args;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--suite") == 0) {
+      suite_only = true;
+    } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_file = argv[++i];
+    } else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) {
+      base_file = argv[++i];
+    } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+      threshold = atof(argv[++i]);
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  const char *w_dir = args.size() > 0 ? args[0] : "weight";
+  const char *b_dir = args.size() > 1 ? args[1] : "bias";
+  const char *in_file = args.size() > 2 ? args[2] : "input/28063_s_out.csv";
+  const char *g_file =
+      args.size() > 3 ? args[3] : "ground_truth/28063_s_out.csv";
+  const char *data_dir = args.size() > 4 ? args[4] : "all_data";
+
+  std::vector<Eigen::MatrixXd> weights;
+  std::vector<Eigen::VectorXd> biases;
+  if (!load_model(w_dir, b_dir, weights, biases)) {
+    fprintf(stderr, "Failed to load model from %s & %s\n", w_dir, b_dir);
+    return 1;
+  }
+
+  FrameSeq frames =
+      extract_vector2(in_file, VectorOut::INPUT);
+  if (frames.empty()) {
+    fprintf(stderr, "Failed to load frames from %s\n", in_file);
+    return 1;
+  }
+
+  if (!suite_only) {
+    bench_single_sample(frames, weights, biases);
+    bench_parse(in_file, w_dir);
+    bench_canonical(frames, extract_vector2(g_file, VectorOut::OUTPUT));
+    bench_projection(data_dir);
+  }
+
+  const std::vector<SuiteResult> results =
+      run_suite(w_dir, in_file, g_file, data_dir, weights, biases);
+  print_suite(results);
+  if (json_file) {
+    if (!write_suite_json(json_file, results)) {
+      fprintf(stderr, "Failed to write %s\n", json_file);
+      return 1;
+    }
+    printf("Wrote %s\n", json_file);
+  }
+  if (base_file) {
+    std::vector<SuiteResult> baseline;
+    if (!read_suite_json(base_file, baseline)) {
+      fprintf(stderr, "Failed to read baseline %s\n", base_file);
+      return 1;
+    }
+    if (compare_suite(results, baseline, threshold) > 0) return 2;
+  }
+
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include "smile_vis_canon.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SVIS_AVX2
+#endif
+
+void to_point_seq(const Eigen::Ref<const RowMatrixXd> &rows, PointSeq &out) {
+  out.resize(rows.rows(), rows.cols() / 2);
+
+  for (unsigned f = 0; f < out.frames; f++) {
+    const double *row = rows.data() + (Eigen::Index)f * rows.outerStride();
+    for (unsigned p = 0; p < out.points; p++) {
+      out.x_track(p)[f] = (float)row[p * 2];
+      out.y_track(p)[f] = (float)row[p * 2 + 1];
+    }
+  }
+}
+
+void get_points(const PointSeq &seq, dd_array<glm::vec3> &out_bin,
+                const unsigned idx) {
+  if (out_bin.size() != seq.points) out_bin.resize(seq.points);
+
+  for (unsigned p = 0; p < seq.points; p++) {
+    out_bin[p] = glm::vec3(seq.x_track(p)[idx], seq.y_track(p)[idx], 0.f);
+  }
+}
+
+void canonical_transforms(const PointSeq &ground, const unsigned pf_r_l,
+                          const unsigned pf_l_l,
+                          const glm::vec2 canonical_iris_pos,
+                          const float canonical_iris_dist,
+                          CanonTransforms &out) {
+  const unsigned n = ground.frames;
+  out.a.resize(n);
+  out.b.resize(n);
+  out.tx.resize(n);
+  out.ty.resize(n);
+
+  const float *rx = ground.x_track(pf_r_l);
+  const float *ry = ground.y_track(pf_r_l);
+  const float *lx = ground.x_track(pf_l_l);
+  const float *ly = ground.y_track(pf_l_l);
+
+  // v = LL - RL, rotating by -atan2(v) & scaling by dist/|v| is
+  // (dist/|v|^2) * [vx vy; -vy vx], so no trig is needed
+  unsigned f = 0;
+#ifdef SVIS_AVX2
+  const __m256 dist = _mm256_set1_ps(canonical_iris_dist);
+  const __m256 pos_x = _mm256_set1_ps(canonical_iris_pos.x);
+  const __m256 pos_y = _mm256_set1_ps(canonical_iris_pos.y);
+  for (; f + 8 <= n; f += 8) {
+    const __m256 r_x = _mm256_loadu_ps(rx + f);
+    const __m256 r_y = _mm256_loadu_ps(ry + f);
+    const __m256 v_x = _mm256_sub_ps(_mm256_loadu_ps(lx + f), r_x);
+    const __m256 v_y = _mm256_sub_ps(_mm256_loadu_ps(ly + f), r_y);
+    const __m256 len2 = _mm256_fmadd_ps(v_x, v_x, _mm256_mul_ps(v_y, v_y));
+    const __m256 k = _mm256_div_ps(dist, len2);
+    const __m256 a = _mm256_mul_ps(k, v_x);
+    const __m256 b = _mm256_mul_ps(k, v_y);
+    // t = pos - M * RL
+    const __m256 t_x =
+        _mm256_sub_ps(pos_x, _mm256_fmadd_ps(a, r_x, _mm256_mul_ps(b, r_y)));
+    const __m256 t_y =
+        _mm256_sub_ps(pos_y, _mm256_fmsub_ps(a, r_y, _mm256_mul_ps(b, r_x)));
+    _mm256_storeu_ps(out.a.data() + f, a);
+    _mm256_storeu_ps(out.b.data() + f, b);
+    _mm256_storeu_ps(out.tx.data() + f, t_x);
+    _mm256_storeu_ps(out.ty.data() + f, t_y);
+  }
+#endif
+  for (; f < n; f++) {
+    const float v_x = lx[f] - rx[f];
+    const float v_y = ly[f] - ry[f];
+    const float k = canonical_iris_dist / (v_x * v_x + v_y * v_y);
+    const float a = k * v_x;
+    const float b = k * v_y;
+    out.a[f] = a;
+    out.b[f] = b;
+    out.tx[f] = canonical_iris_pos.x - (a * rx[f] + b * ry[f]);
+    out.ty[f] = canonical_iris_pos.y - (a * ry[f] - b * rx[f]);
+  }
+}
+
+void apply_transforms(const CanonTransforms &xforms, PointSeq &seq) {
+  const unsigned n = seq.frames;
+  const float *a = xforms.a.data();
+  const float *b = xforms.b.data();
+  const float *tx = xforms.tx.data();
+  const float *ty = xforms.ty.data();
+
+  for (unsigned p = 0; p < seq.points; p++) {
+    float *x = seq.x_track(p);
+    float *y = seq.y_track(p);
+
+    unsigned f = 0;
+#ifdef SVIS_AVX2
+    for (; f + 8 <= n; f += 8) {
+      const __m256 x_v = _mm256_loadu_ps(x + f);
+      const __m256 y_v = _mm256_loadu_ps(y + f);
+      const __m256 a_v = _mm256_loadu_ps(a + f);
+      const __m256 b_v = _mm256_loadu_ps(b + f);
+      // x' = a x + b y + tx, y' = a y - b x + ty
+      const __m256 x_o = _mm256_fmadd_ps(
+          a_v, x_v, _mm256_fmadd_ps(b_v, y_v, _mm256_loadu_ps(tx + f)));
+      const __m256 y_o = _mm256_fmadd_ps(
+          a_v, y_v, _mm256_fnmadd_ps(b_v, x_v, _mm256_loadu_ps(ty + f)));
+      _mm256_storeu_ps(x + f, x_o);
+      _mm256_storeu_ps(y + f, y_o);
+    }
+#endif
+    for (; f < n; f++) {
+      const float x_f = x[f];
+      x[f] = a[f] * x_f + b[f] * y[f] + tx[f];
+      y[f] = a[f] * y[f] - b[f] * x_f + ty[f];
+    }
+  }
+}
+
+bool canonicalize_sequence(PointSeq &input, PointSeq &ground,
+                           const unsigned pf_r_l, const unsigned pf_l_l,
+                           const glm::vec2 canonical_iris_pos,
+                           const float canonical_iris_dist,
+                           CanonTransforms &xforms) {
+  if (pf_r_l >= ground.points || pf_l_l >= ground.points ||
+      input.frames != ground.frames) {
+    return false;
+  }
+
+  canonical_transforms(ground, pf_r_l, pf_l_l, canonical_iris_pos,
+                       canonical_iris_dist, xforms);
+  apply_transforms(xforms, input);
+  apply_transforms(xforms, ground);
+  return true;
+}
+
+bool canonicalize_sequence(PointSeq &input, PointSeq &ground,
+                           const glm::vec2 canonical_iris_pos,
+                           const float canonical_iris_dist,
+                           CanonTransforms &xforms) {
+  const unsigned pf_r_l =
+      find_key(VectorOut::OUTPUT, "Palpebral fissure (RL) x") / 2;
+  const unsigned pf_l_l =
+      find_key(VectorOut::OUTPUT, "Palpebral fissure (LL) x") / 2;
+  return canonicalize_sequence(input, ground, pf_r_l, pf_l_l,
+                               canonical_iris_pos, canonical_iris_dist,
+                               xforms);
+}
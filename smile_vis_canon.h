@@ -0,0 +1,87 @@
+#pragma once
+
+#include "smile_vis_data.h"
+
+/**
+ * Batched canonical space transform
+ *
+ * Canonical space puts Palpebral fissure (RL) at a fixed position, rotates
+ * (RL -> LL) onto the +x axis & scales |LL - RL| to a fixed distance. That
+ * translate/rotate/scale/translate chain is a single similarity transform
+ * per frame:
+ *
+ *   | x' |   |  a  b | | x |   | tx |
+ *   | y' | = | -b  a | | y | + | ty |
+ *
+ * Sequences are stored point-major (1 contiguous track per landmark) so
+ * both computing & applying transforms vectorize across frames.
+ */
+
+/** \brief Landmark sequence in SoA layout ([point * frames + frame]) */
+struct PointSeq {
+  unsigned frames = 0;
+  unsigned points = 0;
+  std::vector<float> x;
+  std::vector<float> y;
+
+  void resize(const unsigned _frames, const unsigned _points) {
+    frames = _frames;
+    points = _points;
+    x.resize((size_t)frames * points);
+    y.resize((size_t)frames * points);
+  }
+  /** \brief Track of 1 landmark over all frames */
+  float *x_track(const unsigned p) { return x.data() + (size_t)p * frames; }
+  float *y_track(const unsigned p) { return y.data() + (size_t)p * frames; }
+  const float *x_track(const unsigned p) const {
+    return x.data() + (size_t)p * frames;
+  }
+  const float *y_track(const unsigned p) const {
+    return y.data() + (size_t)p * frames;
+  }
+};
+
+/** \brief Per frame canonical transforms (a, b, tx, ty above) */
+struct CanonTransforms {
+  std::vector<float> a;
+  std::vector<float> b;
+  std::vector<float> tx;
+  std::vector<float> ty;
+};
+
+/** \brief Split interleaved (x, y, x, y, ...) rows into a PointSeq */
+void to_point_seq(const Eigen::Ref<const RowMatrixXd> &rows, PointSeq &out);
+
+/** \brief Copy frame idx of PointSeq into array of glm::vec3 */
+void get_points(const PointSeq &seq, dd_array<glm::vec3> &out_bin,
+                const unsigned idx);
+
+/**
+ * \brief Compute canonical transform of every frame from its ground truth
+ * \param pf_r_l, pf_l_l Palpebral fissure (RL & LL) points in ground
+ */
+void canonical_transforms(const PointSeq &ground, const unsigned pf_r_l,
+                          const unsigned pf_l_l,
+                          const glm::vec2 canonical_iris_pos,
+                          const float canonical_iris_dist,
+                          CanonTransforms &out);
+
+/** \brief Apply per frame transforms to every point of seq (in place) */
+void apply_transforms(const CanonTransforms &xforms, PointSeq &seq);
+
+/**
+ * \brief Move input & ground truth sequences into canonical space
+ * \param pf_r_l, pf_l_l Palpebral fissure (RL & LL) points in ground
+ * \return false if reference points or frame counts don't match
+ */
+bool canonicalize_sequence(PointSeq &input, PointSeq &ground,
+                           const unsigned pf_r_l, const unsigned pf_l_l,
+                           const glm::vec2 canonical_iris_pos,
+                           const float canonical_iris_dist,
+                           CanonTransforms &xforms);
+
+/** \brief Same as above w/ reference points from registered output keys */
+bool canonicalize_sequence(PointSeq &input, PointSeq &ground,
+                           const glm::vec2 canonical_iris_pos,
+                           const float canonical_iris_dist,
+                           CanonTransforms &xforms);
@@ -0,0 +1,235 @@
+#include "smile_vis_csv.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace {
+/** \brief Delimiter lookup (1 load per character when skipping fields) */
+struct DelimiterTable {
+  bool is_delim[256];
+  DelimiterTable() {
+    for (unsigned i = 0; i < 256; i++) is_delim[i] = false;
+    is_delim[(unsigned char)','] = true;
+    is_delim[(unsigned char)' '] = true;
+    is_delim[(unsigned char)'\t'] = true;
+    is_delim[(unsigned char)'\r'] = true;
+  }
+};
+const DelimiterTable delimiters;
+
+inline bool is_delimiter(const char c) {
+  return delimiters.is_delim[(unsigned char)c];
+}
+
+/** \brief Convert number at [curr, end) (returns end of number or curr) */
+inline const char *to_double(const char *curr, const char *end, double &out) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  const std::from_chars_result res = std::from_chars(curr, end, out);
+  return res.ec == std::errc() ? res.ptr : curr;
+#else
+  // strtod needs a terminated string (mapped files aren't)
+  char buff[64];
+  size_t len = 0;
+  while (curr + len < end && len < sizeof(buff) - 1 &&
+         !is_delimiter(curr[len])) {
+    buff[len] = curr[len];
+    len++;
+  }
+  buff[len] = '\0';
+  char *nxt = nullptr;
+  out = std::strtod(buff, &nxt);
+  return curr + (nxt - buff);
+#endif
+}
+
+/** \brief Format val w/ fixed decimals into out (returns chars written) */
+inline size_t from_float(const float val, const unsigned precision, char *out,
+                         const size_t out_len) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  const std::to_chars_result res = std::to_chars(
+      out, out + out_len, val, std::chars_format::fixed, (int)precision);
+  return res.ec == std::errc() ? (size_t)(res.ptr - out) : 0;
+#else
+  const int len = std::snprintf(out, out_len, "%.*f", (int)precision, val);
+  return len > 0 && (size_t)len < out_len ? (size_t)len : 0;
+#endif
+}
+
+// worst case single value (sign, 39 integer digits of FLT_MAX, point, decimals)
+const size_t max_value_chars = 64;
+}  // namespace
+
+bool CsvScanner::open(const char *file_name) {
+  if (!file.open(file_name)) return false;
+
+  cursor = file.data();
+  file_end = file.data() + file.size();
+  return true;
+}
+
+bool CsvScanner::next_line(const char *&begin, const char *&end) {
+  if (!cursor || cursor >= file_end) return false;
+
+  begin = cursor;
+  const char *nl =
+      (const char *)std::memchr(cursor, '\n', (size_t)(file_end - cursor));
+  end = nl ? nl : file_end;
+  cursor = nl ? nl + 1 : file_end;
+
+  // drop windows line ending
+  if (end > begin && *(end - 1) == '\r') end--;
+  return true;
+}
+
+unsigned CsvScanner::count_remaining_lines() const {
+  if (!cursor) return 0;
+
+  unsigned lines = 0;
+  const char *curr = cursor;
+  while (curr < file_end) {
+    const char *nl =
+        (const char *)std::memchr(curr, '\n', (size_t)(file_end - curr));
+    lines++;
+    if (!nl) break;
+    curr = nl + 1;
+  }
+  return lines;
+}
+
+unsigned parse_number_row(const char *begin, const char *end, double *out,
+                          const unsigned max_vals) {
+  unsigned found = 0;
+  const char *curr = begin;
+  while (curr < end) {
+    if (is_delimiter(*curr)) {
+      curr++;
+      continue;
+    }
+
+    double val = 0.0;
+    const char *nxt = to_double(curr, end, val);
+    if (nxt == curr) {
+      // not a number, skip character
+      curr++;
+      continue;
+    }
+    if (found < max_vals) out[found] = val;
+    found++;
+    curr = nxt;
+  }
+  return found;
+}
+
+bool parse_number(const char *begin, const char *end, double &out) {
+  return parse_number_row(begin, end, &out, 1) > 0;
+}
+
+void CsvSchema::parse_header(const char *begin, const char *end,
+                             const char *delims) {
+  columns = StrLib::tokenize2<64>(std::string(begin, end).c_str(), delims);
+}
+
+int CsvSchema::index_of(const char *name) const {
+  for (unsigned i = 0; i < columns.size(); i++) {
+    if (columns[i] == name) return (int)i;
+  }
+  return -1;
+}
+
+bool ColumnProjection::resolve(const CsvSchema &schema,
+                               const char *const *names,
+                               const unsigned count) {
+  std::vector<unsigned> indices(count);
+  for (unsigned i = 0; i < count; i++) {
+    const int idx = schema.index_of(names[i]);
+    if (idx < 0) {
+      slot.clear();
+      num_out = 0;
+      return false;
+    }
+    indices[i] = (unsigned)idx;
+  }
+  select(indices.data(), count);
+  return true;
+}
+
+void ColumnProjection::select(const unsigned *indices, const unsigned count) {
+  unsigned last = 0;
+  for (unsigned i = 0; i < count; i++) last = std::max(last, indices[i] + 1);
+
+  slot.assign(last, -1);
+  for (unsigned i = 0; i < count; i++) slot[indices[i]] = (int)i;
+  num_out = count;
+}
+
+unsigned parse_projected_row(const char *begin, const char *end,
+                             const ColumnProjection &proj, double *out) {
+  const std::vector<int> &slot = proj.slots();
+  const unsigned num_fields = slot.size();
+
+  unsigned field = 0, found = 0;
+  const char *curr = begin;
+  // stop after last projected column (rest of line is never touched)
+  while (field < num_fields) {
+    while (curr < end && is_delimiter(*curr)) curr++;
+    if (curr >= end) break;
+
+    if (slot[field] >= 0) {
+      double val = 0.0;
+      const char *nxt = to_double(curr, end, val);
+      if (nxt != curr) {
+        out[slot[field]] = val;
+        found++;
+        curr = nxt;
+      }
+    }
+    // skip (rest of) field w/o converting
+    while (curr < end && !is_delimiter(*curr)) curr++;
+    field++;
+  }
+  return found;
+}
+
+bool CsvWriter::open(const char *file_name, const bool append) {
+  close();
+  file = std::fopen(file_name, append ? "ab" : "wb");
+  failed = file == nullptr;
+  return file != nullptr;
+}
+
+bool CsvWriter::close() {
+  if (!file) return !failed;
+
+  flush();
+  failed |= std::fclose(file) != 0;
+  file = nullptr;
+  return !failed;
+}
+
+void CsvWriter::flush() {
+  if (file && used > 0) {
+    failed |= std::fwrite(buff, 1, used, file) != used;
+  }
+  used = 0;
+}
+
+void CsvWriter::write_row(const float *vals, const unsigned count,
+                          const unsigned precision) {
+  if (!file) return;
+
+  const size_t value_chars = max_value_chars + precision;
+  for (unsigned i = 0; i < count; i++) {
+    if (buff_size - used < value_chars + 2) flush();
+    if (i > 0) buff[used++] = ' ';
+    used += from_float(vals[i], precision, buff + used, value_chars);
+  }
+  if (used == buff_size) flush();
+  buff[used++] = '\n';
+}
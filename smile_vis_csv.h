@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdio>
+#include <vector>
+#include "Container.h"
+#include "StringLib.h"
+#include "smile_vis_mmap.h"
+
+/**
+ * Bulk text I/O for the landmark & weight csv files
+ *
+ * CsvScanner maps the whole file & walks lines with memchr (SIMD in every
+ * mainstream libc). parse_number_row() converts delimited numbers straight
+ * into caller storage w/ std::from_chars (locale independent), skipping
+ * ',', ' ', '\t' & '\r' between values. CsvWriter is the output side: one
+ * open per file & rows formatted w/ std::to_chars into a large buffer.
+ *
+ * CsvSchema holds the column names of 1 file. A ColumnProjection resolved
+ * against it lets parse_projected_row() convert only the wanted columns &
+ * step over the rest w/o converting them.
+ */
+
+/** \brief Line iterator over a memory mapped text file */
+class CsvScanner {
+ public:
+  /** \brief Map file (returns false if missing or empty) */
+  bool open(const char *file);
+
+  /**
+   * \brief Get next line (w/o line ending)
+   * \return false at end of file
+   */
+  bool next_line(const char *&begin, const char *&end);
+
+  /** \brief Count lines left from current position (for preallocation) */
+  unsigned count_remaining_lines() const;
+
+  /** \brief Bytes in mapped file */
+  size_t size() const { return file.size(); }
+
+ private:
+  MappedFile file;
+  const char *cursor = nullptr;
+  const char *file_end = nullptr;
+};
+
+/** \brief Buffered writer for space separated rows of numbers */
+class CsvWriter {
+ public:
+  CsvWriter() {}
+  ~CsvWriter() { close(); }
+  CsvWriter(const CsvWriter &) = delete;
+  CsvWriter &operator=(const CsvWriter &) = delete;
+
+  /** \brief Open file for writing (truncates unless append is set) */
+  bool open(const char *file_name, const bool append = false);
+
+  /** \brief Flush buffer & close file (returns false if any write failed) */
+  bool close();
+
+  /** \brief Write values as one line (" " separated, fixed decimals) */
+  void write_row(const float *vals, const unsigned count,
+                 const unsigned precision = 5);
+
+ private:
+  void flush();
+
+  static const size_t buff_size = 1 << 16;
+  FILE *file = nullptr;
+  char buff[buff_size];
+  size_t used = 0;
+  bool failed = false;
+};
+
+/** \brief Column names of a single csv file */
+class CsvSchema {
+ public:
+  /** \brief Split header line [begin, end) into column names */
+  void parse_header(const char *begin, const char *end,
+                    const char *delims = ",");
+
+  /** \brief Index of column (-1 if file doesn't have it) */
+  int index_of(const char *name) const;
+
+  unsigned size() const { return columns.size(); }
+  const dd_array<string64> &names() const { return columns; }
+
+ private:
+  dd_array<string64> columns;
+};
+
+/** \brief Columns to convert when parsing a row (in output order) */
+class ColumnProjection {
+ public:
+  /**
+   * \brief Select named columns of schema
+   * \return false if a column is missing
+   */
+  bool resolve(const CsvSchema &schema, const char *const *names,
+               const unsigned count);
+
+  /** \brief Select columns by index */
+  void select(const unsigned *indices, const unsigned count);
+
+  /** \brief Number of output values per row */
+  unsigned size() const { return num_out; }
+
+  /** \brief Output slot of each source column up to the last used (-1 skip) */
+  const std::vector<int> &slots() const { return slot; }
+
+ private:
+  std::vector<int> slot;
+  unsigned num_out = 0;
+};
+
+/**
+ * \brief Parse projected columns of row [begin, end) into out
+ * \return Number of projected values found
+ */
+unsigned parse_projected_row(const char *begin, const char *end,
+                             const ColumnProjection &proj, double *out);
+
+/**
+ * \brief Parse delimited numbers in [begin, end) into out
+ * \param max_vals Capacity of out (extra values are counted, not written)
+ * \return Number of values found on the line
+ */
+unsigned parse_number_row(const char *begin, const char *end, double *out,
+                          const unsigned max_vals);
+
+/** \brief Parse a single number (returns false if line has none) */
+bool parse_number(const char *begin, const char *end, double &out);
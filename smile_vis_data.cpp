@@ -1,7 +1,14 @@
 #include "smile_vis_data.h"
 #include "ddFileIO.h"
 #include "ddTerminal.h"
+#include "smile_vis_canon.h"
+#include "smile_vis_csv.h"
+#include "smile_vis_seqcache.h"
+#include "smile_vis_stats.h"
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 namespace {
 // log keys for easy indexing
@@ -9,11 +16,177 @@ std::map<string64, unsigned> input_keys;
 std::map<unsigned, float> input_time;
 std::map<string64, unsigned> output_keys;
 std::map<unsigned, float> output_time;
+// guards key maps (files are parsed on export worker threads)
+std::mutex keys_mutex;
+
+/** \brief Log header keys of input/output files (1st file wins) */
+void register_keys(const VectorOut type, dd_array<string64> &indices) {
+  std::lock_guard<std::mutex> lock(keys_mutex);
+  std::map<string64, unsigned> *keys = nullptr;
+  std::map<unsigned, float> *time = nullptr;
+  switch (type) {
+    case VectorOut::INPUT:
+      keys = &input_keys;
+      time = &input_time;
+      break;
+    case VectorOut::OUTPUT:
+      keys = &output_keys;
+      time = &output_time;
+      break;
+    default:
+      return;
+  }
+
+  if (keys->size() == 0) {
+    DD_FOREACH(string64, _key, indices) {
+      // set offset if time column is present (must be 1st column)
+      if (_key.ptr->contains("time")) {
+        (*time)[_key.i] = 0.f;
+      }
+      (*keys)[*_key.ptr] = _key.i;
+    }
+  }
+}
+
+/** \brief Column of key in registered header (0 if not registered) */
+unsigned find_key(const std::map<string64, unsigned> &keys, const char *key) {
+  std::lock_guard<std::mutex> lock(keys_mutex);
+  const std::map<string64, unsigned>::const_iterator it =
+      keys.find(string64(key));
+  return it != keys.end() ? it->second : 0;
+}
+
+/** \brief Output files of a canonical export (<dir>/<file id>_canon.csv) */
+void canonical_file_names(const char *dir, const char *gdir,
+                          const char *file_id, string512 &out_f_name,
+                          string512 &out_fg_name) {
+	string512 f_id = file_id;
+  f_id = f_id.trim(0, 7);
+  out_f_name.format("%s/%s_canon.csv", dir, f_id.str());
+  out_fg_name.format("%s/%s_canon.csv", gdir, f_id.str());
+}
+
+/** \brief Write frame f of each track as 1 interleaved (x y x y ..) row */
+void write_frame(const PointSeq &seq, const unsigned f,
+                 std::vector<float> &row_buff, CsvWriter &out) {
+  row_buff.resize(seq.points * 2);
+  for (unsigned p = 0; p < seq.points; p++) {
+    row_buff[p * 2] = seq.x_track(p)[f];
+    row_buff[p * 2 + 1] = seq.y_track(p)[f];
+  }
+  out.write_row(row_buff.data(), row_buff.size());
+}
+
+/**
+ * \brief Canonicalize one input/ground truth file pair
+ *
+ * Rows are streamed from both mapped files in fixed size chunks, moved into
+ * canonical space w/ the batched transform & written thru 1 buffered writer
+ * per output, so memory doesn't grow w/ the length of the recording.
+ */
+void export_canonical_file(const char *in_file, const char *g_file,
+                           const char *input_dir, const char *ground_dir,
+                           const char *f_name,
+                           const glm::vec2 canonical_iris_pos,
+                           const float canonical_iris_dist,
+                           ExportProgress::File &progress) {
+  SVIS_SCOPE("export_canonical_file");
+  CsvScanner in_scan, g_scan;
+  const char *in_line = nullptr, *in_end = nullptr;
+  const char *g_line = nullptr, *g_end = nullptr;
+  if (!in_scan.open(in_file) || !g_scan.open(g_file) ||
+      !in_scan.next_line(in_line, in_end) || !g_scan.next_line(g_line, g_end)) {
+    ddTerminal::f_post("[error]Export: can't read %s or %s", in_file, g_file);
+    return;
+  }
+  SVIS_BYTES("export_canonical_file", in_scan.size() + g_scan.size());
+
+  // get input/output keys (reference points are resolved once per file)
+  CsvSchema in_schema, g_schema;
+  in_schema.parse_header(in_line, in_end, ",");
+  g_schema.parse_header(g_line, g_end, ",");
+  dd_array<string64> in_keys = in_schema.names();
+  dd_array<string64> g_keys = g_schema.names();
+  register_keys(VectorOut::INPUT, in_keys);
+  register_keys(VectorOut::OUTPUT, g_keys);
+  const unsigned in_cols = in_schema.size();
+  const unsigned g_cols = g_schema.size();
+  const int pf_r_l = g_schema.index_of("Palpebral fissure (RL) x");
+  const int pf_l_l = g_schema.index_of("Palpebral fissure (LL) x");
+  if (pf_r_l < 0 || pf_l_l < 0) {
+    ddTerminal::f_post(
+        "[error]Export: %s is missing palpebral fissure columns", g_file);
+    return;
+  }
+  progress.frames =
+      std::min(in_scan.count_remaining_lines(), g_scan.count_remaining_lines());
+
+  string512 out_f_name, out_fg_name;
+  canonical_file_names(input_dir, ground_dir, f_name, out_f_name, out_fg_name);
+  CsvWriter i_out, g_out;
+  if (!i_out.open(out_f_name.str()) || !g_out.open(out_fg_name.str())) {
+    ddTerminal::f_post("[error]Export: can't create %s or %s",
+                       out_f_name.str(), out_fg_name.str());
+    return;
+  }
+
+  // chunk buffers, reused until the end of the file
+  const unsigned chunk = 1024;
+  RowMatrixXd in_rows(chunk, in_cols), g_rows(chunk, g_cols);
+  PointSeq in_p, g_p;
+  CanonTransforms xforms;
+  std::vector<float> row_buff;
+  unsigned frames = 0;
+  bool has_rows = true;
+  while (has_rows) {
+    unsigned rows = 0;
+    while (rows < chunk && in_scan.next_line(in_line, in_end) &&
+           g_scan.next_line(g_line, g_end) && in_line != in_end &&
+           g_line != g_end) {
+      const unsigned in_found =
+          parse_number_row(in_line, in_end, &in_rows(rows, 0), in_cols);
+      const unsigned g_found =
+          parse_number_row(g_line, g_end, &g_rows(rows, 0), g_cols);
+      if (in_found != in_cols || g_found != g_cols) {
+        ddTerminal::f_post("[error]%s row %u: %u/%u values (expected %u/%u)",
+                           f_name, frames + rows, in_found, g_found, in_cols,
+                           g_cols);
+      }
+      rows++;
+    }
+    has_rows = rows == chunk;
+    if (rows == 0) break;
+
+    to_point_seq(in_rows.topRows(rows), in_p);
+    to_point_seq(g_rows.topRows(rows), g_p);
+    if (!canonicalize_sequence(in_p, g_p, pf_r_l / 2, pf_l_l / 2,
+                               canonical_iris_pos, canonical_iris_dist,
+                               xforms)) {
+      ddTerminal::f_post("[error]Export: %s reference columns out of range",
+                         g_file);
+      break;
+    }
+    for (unsigned f = 0; f < rows; f++) {
+      write_frame(in_p, f, row_buff, i_out);
+      write_frame(g_p, f, row_buff, g_out);
+    }
+    frames += rows;
+    progress.frames_done = frames;
+  }
+  progress.frames = frames;
+
+  const bool i_ok = i_out.close();
+  const bool g_ok = g_out.close();
+  if (!i_ok || !g_ok) {
+    ddTerminal::f_post("[error]Export: failed writing %s or %s",
+                       out_f_name.str(), out_fg_name.str());
+  }
+}
 }  // namespace
 
-std::vector<double> feedForward(Eigen::VectorXd &inputs,
-                                std::vector<Eigen::MatrixXd> &weights,
-                                std::vector<Eigen::VectorXd> &biases) {
+std::vector<double> feedForward(
+    const Eigen::Ref<const Eigen::VectorXd> &inputs,
+    std::vector<Eigen::MatrixXd> &weights, std::vector<Eigen::VectorXd> &biases) {
   // output is class id
   int layers = weights.size();
   // inputs are assumed normalized where appropriate
@@ -44,175 +217,247 @@ std::vector<double> feedForward(Eigen::VectorXd &inputs,
   return output;
 }
 
+void feedForward_batch(const FrameSeq &inputs,
+                       const std::vector<Eigen::MatrixXd> &weights,
+                       const std::vector<Eigen::VectorXd> &biases,
+                       RowMatrixXd &output) {
+  const int layers = weights.size();
+  if (inputs.empty() || layers == 0) {
+    output.resize(0, 0);
+    return;
+  }
+
+  // frames are already stacked (1 sample per row), so the 1st layer reads
+  // the sequence block directly
+  // weights are stored (in x out) so each layer is one GEMM w/o transpose
+  RowMatrixXd layerin, layerout;
+  for (int i = 0; i < layers; i++) {
+    const RowMatrixXd &src = i == 0 ? inputs.matrix() : layerin;
+    POW2_VERIFY_MSG(weights[i].rows() == src.cols(),
+                    "Input and weights have incompatible dimensions at layer %d",
+                    i);
+    layerout.noalias() = src * weights[i];
+    // bias + component wise RELU in one pass
+    if (i < layers - 1) {
+      layerout = (layerout.rowwise() + biases[i].transpose()).cwiseMax(0.0);
+    } else {
+      layerout.rowwise() += biases[i].transpose();
+    }
+    layerin.swap(layerout);
+  }
+  output.swap(layerin);
+}
+
 Eigen::VectorXd extract_vector(const char *in_file) {
+  SVIS_SCOPE("extract_vector");
   Eigen::VectorXd out_vec;
-  ddIO vec_io;
+  CsvScanner vec_io;
 
-  bool success = vec_io.open(in_file, ddIOflag::READ);
+  bool success = vec_io.open(in_file);
 
   if (success) {
     // get vector size
-    unsigned long vec_size = 0;
-    const char *line = vec_io.readNextLine();
-    if (line && *line) vec_size = std::strtoul(line, NULL, 10);
+    const char *line = nullptr, *line_end = nullptr;
+    double vec_size = 0.0;
+    if (vec_io.next_line(line, line_end)) {
+      parse_number(line, line_end, vec_size);
+    }
 
-    printf("    Creating new vector (%lu)...\n", vec_size);
-    out_vec = Eigen::VectorXd::Zero(vec_size);
+    SVIS_BYTES("extract_vector", vec_io.size());
+    out_vec = Eigen::VectorXd::Zero((unsigned long)vec_size);
 
     // populate vector
-    line = vec_io.readNextLine();
     unsigned idx = 0;
-    while (line && *line) {
-      out_vec(idx) = std::strtod(line, NULL);
-
-      line = vec_io.readNextLine();
+    while (vec_io.next_line(line, line_end) && line != line_end) {
+      if (idx >= out_vec.size()) {
+        ddTerminal::f_post("[error]%s: more than %u values", in_file, idx);
+        break;
+      }
+      parse_number(line, line_end, out_vec(idx));
       idx++;
     }
-    // std::cout << out_vec << "\n";
+    // partially written file (e.g. mid retraining)
+    if (idx < out_vec.size()) {
+      ddTerminal::f_post("[error]%s: %u of %u values", in_file, idx,
+                         (unsigned)out_vec.size());
+      out_vec.resize(0);
+    }
   }
 
   return out_vec;
 }
 
-std::vector<Eigen::VectorXd> extract_vector2(const char *in_file,
-                                             const VectorOut type) {
-  std::vector<Eigen::VectorXd> out_vec;
-  ddIO vec_io;
+FrameSeq extract_vector2(const char *in_file, const VectorOut type) {
+  SVIS_SCOPE("extract_vector2");
+  FrameSeq out_vec;
+  dd_array<string64> indices;
 
-  bool success = vec_io.open(in_file, ddIOflag::READ);
+  // reuse binary cache if source hasn't changed since last parse
+  if (load_seq_cache(in_file, type, indices, out_vec)) {
+    register_keys(type, indices);
+    return out_vec;
+  }
+
+  CsvScanner vec_io;
+
+  bool success = vec_io.open(in_file);
 
   if (success) {
+    SVIS_BYTES("extract_vector2", vec_io.size());
     // get vector size
-    const char *line = vec_io.readNextLine();
-    dd_array<string64> indices;
+    const char *line = nullptr, *line_end = nullptr;
+    vec_io.next_line(line, line_end);
+    CsvSchema schema;
+    bool has_row = true;
 
     switch (type) {
       case VectorOut::INPUT:
-        // get input keys
-        indices = StrLib::tokenize2<64>(line, ",");
-        if (input_keys.size() == 0) {
-          DD_FOREACH(string64, _key, indices) {
-            // set offset if time column is present (must be 1st column)
-            if (_key.ptr->contains("time")) {
-							input_time[_key.i] = 0.f;
-            }
-            input_keys[*_key.ptr] = _key.i;
-          }
-        }
-        // skip to next line in file
-        line = vec_io.readNextLine();
-        break;
       case VectorOut::OUTPUT:
-        // get output keys
-        indices = StrLib::tokenize2<64>(line, ",");
-        if (output_keys.size() == 0) {
-          DD_FOREACH(string64, _key, indices) {
-            if (_key.ptr->contains("time")) {
-							output_time[_key.i] = 0.f;
-            }
-            output_keys[*_key.ptr] = _key.i;
-          }
-        }
+        // get input/output keys
+        schema.parse_header(line, line_end, ",");
+        indices = schema.names();
+        register_keys(type, indices);
         // skip to next line in file
-        line = vec_io.readNextLine();
+        has_row = vec_io.next_line(line, line_end);
         break;
       case VectorOut::INPUT_C:
-        indices = StrLib::tokenize2<64>(line, " ");
-        break;
       case VectorOut::OUTPUT_C:
-        indices = StrLib::tokenize2<64>(line, " ");
+        // no header, 1st row only gives the column count
+        schema.parse_header(line, line_end, " ");
+        indices = schema.names();
         break;
       default:
         break;
     }
     const unsigned vec_size = indices.size();
 
-    // ddTerminal::f_post("Creating new input vectors(%lu)...", vec_size);
-    // populate vector
+    // populate sequence (single allocation sized from the line count)
+    out_vec.resize(vec_io.count_remaining_lines() + 1, vec_size);
     unsigned idx = 0;
-    while (line && *line) {
-      out_vec.push_back(Eigen::VectorXd::Zero(vec_size));
-
-      // loop thru columns per row
-      unsigned r_idx = 0;
-      const char *curr_row = line;
-      while (*curr_row) {
-        char *nxt_dbl = nullptr;
-        // printf("%s\n", curr_row);
-        out_vec[idx](r_idx) = std::strtod(curr_row, &nxt_dbl);
-        curr_row = nxt_dbl;
-
-        r_idx++;
+    while (has_row && line != line_end && idx < out_vec.size()) {
+      const unsigned found =
+          parse_number_row(line, line_end, out_vec.row_data(idx), vec_size);
+      if (found != vec_size) {
+        ddTerminal::f_post("[error]%s row %u: %u values (expected %u)",
+                           in_file, idx, found, vec_size);
       }
-      // std::cout << out_vec[idx] << "\n\n";
 
-      line = vec_io.readNextLine();
+      has_row = vec_io.next_line(line, line_end);
       idx++;
     }
+    // drop rows reserved for blank trailing lines
+    out_vec.truncate(idx);
+
+    // canonical files have no header row, so there are no names to keep
+    if (type == VectorOut::INPUT_C || type == VectorOut::OUTPUT_C) {
+      indices.resize(0);
+    }
+    save_seq_cache(in_file, type, indices, out_vec);
+  }
+
+  return out_vec;
+}
+
+FrameSeq extract_columns(const char *in_file, const char *const *columns,
+                         const unsigned num_columns) {
+  FrameSeq out_vec;
+  CsvScanner vec_io;
+  const char *line = nullptr, *line_end = nullptr;
+  if (!vec_io.open(in_file) || !vec_io.next_line(line, line_end)) {
+    return out_vec;
+  }
+
+  CsvSchema schema;
+  schema.parse_header(line, line_end, ",");
+  ColumnProjection proj;
+  if (!proj.resolve(schema, columns, num_columns)) {
+    ddTerminal::f_post("[error]%s: missing requested columns", in_file);
+    return out_vec;
+  }
+
+  out_vec.resize(vec_io.count_remaining_lines(), num_columns);
+  unsigned idx = 0;
+  while (idx < out_vec.size() && vec_io.next_line(line, line_end) &&
+         line != line_end) {
+    const unsigned found =
+        parse_projected_row(line, line_end, proj, out_vec.row_data(idx));
+    if (found != num_columns) {
+      ddTerminal::f_post("[error]%s row %u: %u values (expected %u)", in_file,
+                         idx, found, num_columns);
+    }
+    idx++;
   }
+  out_vec.truncate(idx);
 
   return out_vec;
 }
 
 Eigen::MatrixXd extract_matrix(const char *in_file) {
+  SVIS_SCOPE("extract_matrix");
   Eigen::MatrixXd out_mat;
-  ddIO mat_io;
+  CsvScanner mat_io;
 
-  bool success = mat_io.open(in_file, ddIOflag::READ);
+  bool success = mat_io.open(in_file);
 
   if (success) {
     // get matrix size
-    unsigned long mat_size[2] = {0, 0};
-    const char *line = mat_io.readNextLine();
-    char *nxt_num = nullptr;
-    if (line && *line) {
-      // doesn't work if line doesn't have 2 number white-space separated
-      mat_size[0] = std::strtoul(line, &nxt_num, 10);
-      mat_size[1] = std::strtoul(nxt_num, NULL, 10);
+    double mat_size[2] = {0.0, 0.0};
+    const char *line = nullptr, *line_end = nullptr;
+    if (mat_io.next_line(line, line_end)) {
+      parse_number_row(line, line_end, mat_size, 2);
     }
+    const unsigned rows = (unsigned)mat_size[0];
+    const unsigned cols = (unsigned)mat_size[1];
 
-    printf("    Creating new matrix (%lu, %lu)...\n", mat_size[0], mat_size[1]);
-    out_mat = Eigen::MatrixXd::Zero(mat_size[0], mat_size[1]);
+    SVIS_BYTES("extract_matrix", mat_io.size());
+    out_mat.resize(rows, cols);
 
-    // populate matrix
-    line = mat_io.readNextLine();
+    // populate matrix (parse into row buffer then scatter into column-major,
+    // every row is complete or the matrix is dropped)
+    Eigen::RowVectorXd row_buff = Eigen::RowVectorXd::Zero(cols);
     unsigned r_idx = 0;
-    while (line && *line) {
-      // loop thru columns per row
-      unsigned c_idx = 0;
-      const char *curr_row = line;
-      while (*curr_row) {
-        char *nxt_dbl = nullptr;
-        // printf("%s\n", curr_row);
-        out_mat(r_idx, c_idx) = std::strtod(curr_row, &nxt_dbl);
-        curr_row = nxt_dbl;
-
-        c_idx++;
+    bool complete = true;
+    while (mat_io.next_line(line, line_end) && line != line_end) {
+      if (r_idx >= rows) {
+        ddTerminal::f_post("[error]%s: more than %u rows", in_file, rows);
+        break;
+      }
+      const unsigned found =
+          parse_number_row(line, line_end, row_buff.data(), cols);
+      if (found != cols) {
+        ddTerminal::f_post("[error]%s row %u: %u values (expected %u)",
+                           in_file, r_idx, found, cols);
+        complete = false;
+        break;
       }
+      out_mat.row(r_idx) = row_buff;
 
-      line = mat_io.readNextLine();
       r_idx++;
     }
-    // std::cout << out_mat << "\n";
+    // partially written file (e.g. mid retraining)
+    if (complete && r_idx < rows) {
+      ddTerminal::f_post("[error]%s: %u of %u rows", in_file, r_idx, rows);
+      complete = false;
+    }
+    if (!complete) out_mat.resize(0, 0);
   }
 
   return out_mat;
 }
 
-void get_points(std::vector<Eigen::VectorXd> &v_bin,
-                dd_array<glm::vec3> &out_bin, const unsigned idx,
-                const VectorOut type) {
+void get_points(const FrameSeq &v_bin, dd_array<glm::vec3> &out_bin,
+                const unsigned idx, const VectorOut type) {
+  const double *row = v_bin.row_data(idx);
   if (type == VectorOut::INPUT) {
     // use all values
-    if ((int)out_bin.size() != (v_bin[idx].size() / 2)) {
-      out_bin.resize(v_bin[idx].size() / 2);
+    if (out_bin.size() != (v_bin.cols() / 2)) {
+      out_bin.resize(v_bin.cols() / 2);
     }
 
     unsigned c_idx = 0;
 
     while (c_idx < out_bin.size()) {
-      out_bin[c_idx] =
-          glm::vec3(v_bin[idx](c_idx * 2), v_bin[idx](c_idx * 2 + 1), 0.f);
+      out_bin[c_idx] = glm::vec3(row[c_idx * 2], row[c_idx * 2 + 1], 0.f);
       c_idx++;
     }
 
@@ -225,13 +470,12 @@ void get_points(std::vector<Eigen::VectorXd> &v_bin,
   } else {
     // use all values
 		unsigned c_idx = 0;
-    if ((int)out_bin.size() != ((v_bin[idx].size()) / 2)) {
-      out_bin.resize((v_bin[idx].size()) / 2);
+    if (out_bin.size() != ((v_bin.cols()) / 2)) {
+      out_bin.resize((v_bin.cols()) / 2);
     }
 
     while ((c_idx) < out_bin.size()) {
-      out_bin[c_idx] =
-          glm::vec3(v_bin[idx](c_idx * 2), v_bin[idx](c_idx * 2 + 1), 0.f);
+      out_bin[c_idx] = glm::vec3(row[c_idx * 2], row[c_idx * 2 + 1], 0.f);
       c_idx++;
     }
 
@@ -253,7 +497,8 @@ void get_points(std::vector<Eigen::VectorXd> &v_bin,
   }
 }
 
-void get_points(Eigen::VectorXd &input, std::vector<Eigen::MatrixXd> &weights,
+void get_points(const Eigen::Ref<const Eigen::VectorXd> &input,
+                std::vector<Eigen::MatrixXd> &weights,
                 std::vector<Eigen::VectorXd> &biases,
                 dd_array<glm::vec3> &output) {
   std::vector<double> out_d = feedForward(input, weights, biases);
@@ -286,167 +531,219 @@ void get_points(Eigen::VectorXd &input, std::vector<Eigen::MatrixXd> &weights,
   // Malar eminence (R) x,Malar eminence (R) y
 }
 
-std::map<string64, unsigned> &get_input_keys() { return input_keys; }
-
-std::map<string64, unsigned> &get_output_keys() { return output_keys; }
-
-void export_canonical_data(dd_array<glm::vec3> &input,
-                           dd_array<glm::vec3> &ground, const char *dir,
-                           const char *gdir, const char *file_id,
-                           const glm::vec2 canonical_iris_pos,
-                           const float canonical_iris_dist, const bool append) {
-  // create new file
-	string512 f_id = file_id;
-  f_id = f_id.trim(0, 7);
-  string512 out_f_name, out_fg_name;
-  out_f_name.format("%s/%s_canon.csv", dir, f_id.str());
-  out_fg_name.format("%s/%s_canon.csv", gdir, f_id.str());
-  // ddTerminal::f_post("Creating: %s", out_f_name.str());
-
-  // get translation offset (Iris (M) x, Iris (M) y)
-  string64 map_idx = "Iris (M) x";
-  const unsigned iris_m_idx = input_keys[map_idx]/2;
-	map_idx = "Iris (L) x";
-  const unsigned iris_l_idx = input_keys[map_idx]/2;
-  // glm::vec2 delta_pos = glm::vec2(-input[iris_l_idx]);
-
-  // palpebral fissure delta and center
-	map_idx = "Palpebral fissure (RL) x";
-  const unsigned pf_r_l = output_keys[map_idx] / 2;
-	map_idx = "Palpebral fissure (LL) x";
-  const unsigned pf_l_l = output_keys[map_idx] / 2;
-  glm::vec2 delta_pos = glm::vec2(-ground[pf_r_l]);
-  // ddTerminal::f_post("PF R L: %.3f", -delta_pos.y);
-
-  // apply delta translation to all points
-  dd_array<glm::vec2> input_n(input.size());
-  dd_array<glm::vec2> ground_n(ground.size());
-
-  DD_FOREACH(glm::vec3, vec, input) {  // input
-    input_n[vec.i] = glm::vec2(*vec.ptr) + delta_pos;
-  }
-  DD_FOREACH(glm::vec3, vec, ground) {  // ground truth
-    ground_n[vec.i] = glm::vec2(*vec.ptr) + delta_pos;
+void get_points(const RowMatrixXd &v_bin, dd_array<glm::vec3> &out_bin,
+                const unsigned idx) {
+  if (out_bin.size() != (v_bin.cols() / 2)) {
+    out_bin.resize(v_bin.cols() / 2);
   }
 
-  // get rotation offset b/t lateral & medial iris
-  const float rot_offset = atan2(ground_n[pf_l_l].y, ground_n[pf_l_l].x);
-  glm::mat2 r_mat;
-  r_mat[0][0] = glm::cos(-rot_offset);
-  r_mat[0][1] = glm::sin(-rot_offset);
-  r_mat[1][0] = -glm::sin(-rot_offset);
-  r_mat[1][1] = glm::cos(-rot_offset);
+  const double *row = v_bin.data() + idx * v_bin.cols();
+  for (unsigned c_idx = 0; c_idx < out_bin.size(); c_idx++) {
+    out_bin[c_idx] = glm::vec3(row[c_idx * 2], row[c_idx * 2 + 1], 0.f);
+  }
+}
 
-  // apply negative rotation to all points (at the current pos)
-  DD_FOREACH(glm::vec2, vec, input_n) {  // input
-    input_n[vec.i] = r_mat * (*vec.ptr);
+void landmark_errors(const RowMatrixXd &predict, const RowMatrixXd &ground,
+                     Eigen::MatrixXf &out) {
+  const Eigen::Index frames = std::min(predict.rows(), ground.rows());
+  const Eigen::Index skip = predict.cols() - ground.cols();
+  if (frames == 0 || skip < 0) {
+    out.resize(0, 0);
+    return;
   }
-  DD_FOREACH(glm::vec2, vec, ground_n) {  // ground
-    ground_n[vec.i] = r_mat * (*vec.ptr);
+
+  // whole sequence at once: x & y deltas are the even/odd columns
+  const Eigen::ArrayXXd delta =
+      (predict.block(0, skip, frames, ground.cols()) - ground.topRows(frames))
+          .array();
+  out.resize(frames, ground.cols() / 2);
+  for (Eigen::Index l = 0; l < out.cols(); l++) {
+    out.col(l) = (delta.col(l * 2).square() + delta.col(l * 2 + 1).square())
+                     .sqrt()
+                     .cast<float>();
   }
+}
 
-  // scale points so that iris distance is set to a canonical distance
-  const float dist = glm::distance(ground_n[pf_r_l], ground_n[pf_l_l]);
-  const float scale_factor = canonical_iris_dist / dist;
-  glm::mat2 s_mat;
-  s_mat[0][0] = s_mat[1][1] = scale_factor;
-  s_mat[0][1] = s_mat[1][0] = 0.f;
+bool grow_bounds(const RowMatrixXd &rows, const unsigned skip,
+                 glm::vec4 &bounds) {
+  if (rows.rows() == 0 || rows.cols() < (Eigen::Index)skip + 2) return false;
+  const Eigen::Index cols = (rows.cols() - skip) & ~(Eigen::Index)1;
+
+  // column extremes over all frames at once, then x (even) & y (odd) columns
+  const Eigen::RowVectorXd lo =
+      rows.middleCols(skip, cols).colwise().minCoeff();
+  const Eigen::RowVectorXd hi =
+      rows.middleCols(skip, cols).colwise().maxCoeff();
+  typedef Eigen::Map<const Eigen::VectorXd, 0, Eigen::InnerStride<2>> Axis;
+  bounds.x = std::min(bounds.x, (float)Axis(lo.data(), cols / 2).minCoeff());
+  bounds.y =
+      std::min(bounds.y, (float)Axis(lo.data() + 1, cols / 2).minCoeff());
+  bounds.z = std::max(bounds.z, (float)Axis(hi.data(), cols / 2).maxCoeff());
+  bounds.w =
+      std::max(bounds.w, (float)Axis(hi.data() + 1, cols / 2).maxCoeff());
+  return true;
+}
 
-  DD_FOREACH(glm::vec2, vec, input_n) {  // input
-    input_n[vec.i] = s_mat * (*vec.ptr);
-  }
-  DD_FOREACH(glm::vec2, vec, ground_n) {  // ground
-    ground_n[vec.i] = s_mat * (*vec.ptr);
+std::vector<string64> landmark_names(const VectorOut type,
+                                     const unsigned landmarks) {
+  std::vector<string64> names(landmarks);
+  for (unsigned l = 0; l < landmarks; l++) names[l].format("landmark %u", l);
+
+  std::lock_guard<std::mutex> lock(keys_mutex);
+  const std::map<string64, unsigned> &keys =
+      type == VectorOut::INPUT ? input_keys : output_keys;
+  for (std::map<string64, unsigned>::const_iterator it = keys.begin();
+       it != keys.end(); ++it) {
+    const unsigned col = it->second;
+    if (col % 2 != 0 || col / 2 >= landmarks) continue;
+    const string64 &key = it->first;
+    names[col / 2] = key.length() > 2 ? key.trim(0, key.length() - 2) : key;
   }
+  return names;
+}
 
-  // apply translation to all points to move iris to canonical position
-  DD_FOREACH(glm::vec2, vec, input_n) {
-    // ddTerminal::f_post("#%u : %.3f, %.3f", vec.i, vec.ptr->x, vec.ptr->y);
-		*vec.ptr += canonical_iris_pos;
-  }
-  DD_FOREACH(glm::vec2, vec, ground_n) {
-    // ddTerminal::f_post("----> %.3f, %.3f", input_n[vec.i].x,
-    // input_n[vec.i].y);
-    *vec.ptr += canonical_iris_pos;
+unsigned find_key(const VectorOut type, const char *key) {
+  switch (type) {
+    case VectorOut::INPUT:
+      return find_key(input_keys, key);
+    case VectorOut::OUTPUT:
+      return find_key(output_keys, key);
+    default:
+      return 0;
   }
+}
 
-  // write out input and ground file
-  ddIO i_out, g_out;
-  if (append) {
-    i_out.open(out_f_name.str(), ddIOflag::APPEND);
-  } else {
-    i_out.open(out_f_name.str(), ddIOflag::WRITE);
+int time_column(const VectorOut type) {
+  std::lock_guard<std::mutex> lock(keys_mutex);
+  const std::map<unsigned, float> *time = nullptr;
+  switch (type) {
+    case VectorOut::INPUT:
+      time = &input_time;
+      break;
+    case VectorOut::OUTPUT:
+      time = &output_time;
+      break;
+    default:
+      return -1;
   }
+  return time->empty() ? -1 : (int)time->begin()->first;
+}
 
-  string512 out_str;
-  string8 x_val, y_val;
-  DD_FOREACH(glm::vec2, vec, input_n) {
-		x_val.format(" %.5f", vec.ptr->x);
-		y_val.format(" %.5f", vec.ptr->y);
-		out_str = out_str + x_val + y_val;
-  }
-  out_str.format("%s\n", out_str.str(1));
-  // ddTerminal::post(out_str.c_str());
-  i_out.writeLine(out_str.str());
+std::map<string64, unsigned> &get_input_keys() { return input_keys; }
 
-  if (append) {
-    g_out.open(out_fg_name.str(), ddIOflag::APPEND);
-  } else {
-    g_out.open(out_fg_name.str(), ddIOflag::WRITE);
-  }
+std::map<string64, unsigned> &get_output_keys() { return output_keys; }
 
-  out_str = "";
-  DD_FOREACH(glm::vec2, vec, ground_n) {
-		x_val.format(" %.5f", vec.ptr->x);
-		y_val.format(" %.5f", vec.ptr->y);
-		out_str = out_str + x_val + y_val;
+void export_canonical_data(dd_array<glm::vec3> &input,
+                           dd_array<glm::vec3> &ground, const char *dir,
+                           const char *gdir, const char *file_id,
+                           const glm::vec2 canonical_iris_pos,
+                           const float canonical_iris_dist, const bool append) {
+  // create new file
+  string512 out_f_name, out_fg_name;
+  canonical_file_names(dir, gdir, file_id, out_f_name, out_fg_name);
+
+  // 1 frame sequences
+  PointSeq input_n, ground_n;
+  input_n.resize(1, input.size());
+  ground_n.resize(1, ground.size());
+  DD_FOREACH(glm::vec3, vec, input) {
+    input_n.x[vec.i] = vec.ptr->x;
+    input_n.y[vec.i] = vec.ptr->y;
+  }
+  DD_FOREACH(glm::vec3, vec, ground) {
+    ground_n.x[vec.i] = vec.ptr->x;
+    ground_n.y[vec.i] = vec.ptr->y;
+  }
+  CanonTransforms xform;
+  if (!canonicalize_sequence(input_n, ground_n, canonical_iris_pos,
+                             canonical_iris_dist, xform)) {
+    return;
   }
-	out_str.format("%s\n", out_str.str(1));
-  g_out.writeLine(out_str.str());
+
+  // write out input and ground file
+  std::vector<float> row_buff;
+  CsvWriter i_out, g_out;
+  i_out.open(out_f_name.str(), append);
+  write_frame(input_n, 0, row_buff, i_out);
+  g_out.open(out_fg_name.str(), append);
+  write_frame(ground_n, 0, row_buff, g_out);
 }
 
 void export_canonical(const char *input_dir, const char *ground_dir,
                       const glm::vec2 canonical_iris_pos,
-                      const float canonical_iris_dist) {
+                      const float canonical_iris_dist,
+                      const unsigned num_threads, ExportProgress *progress) {
+  SVIS_SCOPE("export_canonical");
+  typedef std::chrono::high_resolution_clock clock;
+  ExportProgress local_progress;
+  ExportProgress &prog = progress ? *progress : local_progress;
+
   // export input files
   ddIO io_input, io_ground;
-  bool success = io_input.open(input_dir, ddIOflag::DIRECTORY);
-  success |= io_ground.open(ground_dir, ddIOflag::DIRECTORY);
-  if (success) {
+  // files are paired by index, so both folders are needed
+  const bool success = io_input.open(input_dir, ddIOflag::DIRECTORY) &&
+                       io_ground.open(ground_dir, ddIOflag::DIRECTORY);
+  if (!success) {
+    ddTerminal::f_post("[error]Export: can't list %s or %s", input_dir,
+                       ground_dir);
+    prog.failed = true;
+  } else {
     // for each file:
     dd_array<string512> i_files = io_input.get_directory_files();
     dd_array<string512> g_files = io_ground.get_directory_files();
     ddTerminal::f_post("Opening in dir: %s..", input_dir);
     ddTerminal::f_post("Opening ground dir: %s..", ground_dir);
+
+    // 1 task per subject file (skip previously exported files)
+    std::vector<unsigned> jobs;
+    std::vector<string32> names;
     DD_FOREACH(string512, file, i_files) {
-      const char *g_file = g_files[file.i].str();
       // get name of file
 			dd_array<unsigned> token_idx = StrLib::tokenize(file.ptr->str(), "\\/");
       const unsigned idx = token_idx[token_idx.size() - 1];
       const string32 f_name = file.ptr->str(idx + 1);
 
       if (!f_name.contains("canon")) {
-        ddTerminal::f_post("  Exporting: %s", f_name.str());
-
-        // extract contents of each file and convert to glm vectors
-        std::vector<Eigen::VectorXd> i_vec =
-            extract_vector2(file.ptr->str(), VectorOut::INPUT);
-        std::vector<Eigen::VectorXd> g_vec =
-            extract_vector2(g_file, VectorOut::OUTPUT);
-
-        // loop thru lines fo each and write to output file
-        for (size_t j = 0; j < i_vec.size(); j++) {
-          dd_array<glm::vec3> i_p, g_p;
-          get_points(i_vec, i_p, j, VectorOut::INPUT);
-          get_points(g_vec, g_p, j, VectorOut::OUTPUT);
-
-          const bool append = (j == 0) ? false : true;
-          export_canonical_data(i_p, g_p, input_dir, ground_dir, f_name.str(),
-                                canonical_iris_pos, canonical_iris_dist,
-                                append);
-        }
-        ddTerminal::post("---> Done.");
+        jobs.push_back(file.i);
+        names.push_back(f_name);
       }
     }
+    prog.files = std::vector<ExportProgress::File>(jobs.size());
+    for (unsigned j = 0; j < jobs.size(); j++) prog.files[j].name = names[j];
+
+    unsigned threads =
+        num_threads > 0 ? num_threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min(threads, (unsigned)jobs.size()));
+    prog.threads = threads;
+    prog.started = true;
+
+    // fixed pool pulls files off a shared counter until done or cancelled
+    const clock::time_point t_start = clock::now();
+    std::atomic<unsigned> next_job(0);
+    auto worker = [&]() {
+      for (unsigned j = next_job++; j < jobs.size() && !prog.cancel;
+           j = next_job++) {
+        export_canonical_file(i_files[jobs[j]].str(), g_files[jobs[j]].str(),
+                              input_dir, ground_dir, names[j].str(),
+                              canonical_iris_pos, canonical_iris_dist,
+                              prog.files[j]);
+        prog.frames_done += prog.files[j].frames_done;
+        prog.files_done++;
+      }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+    prog.seconds =
+        std::chrono::duration<double>(clock::now() - t_start).count();
+
+    ddTerminal::f_post(
+        "---> %s: %u/%u files, %lu frames in %.2f s (%u threads, %.0f "
+        "frames/s)",
+        prog.cancel ? "Cancelled" : "Done", prog.files_done.load(),
+        (unsigned)jobs.size(), prog.frames_done.load(), prog.seconds,
+        threads, prog.frames_done / std::max(prog.seconds, 1e-9));
   }
+  prog.finished = true;
 }
@@ -1,37 +1,151 @@
+#pragma once
+
 #include "Container.h"
 #include "Eigen/Core"
 #include "ddIncludes.h"
 #include "StringLib.h"
+#include <atomic>
+#include <cfloat>
 #include <vector>
 #include <map>
 
 enum class VectorOut : unsigned { INPUT, OUTPUT, CALC, INPUT_C, OUTPUT_C };
 
+/** \brief Row-major matrix (1 sample/frame per row) */
+typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMatrixXd;
+
+/**
+ * \brief Landmark sequence stored as one row-major block (1 frame per row)
+ *
+ * Column count is fixed when the file is parsed. Indexing returns a view
+ * of the frame, so frames are never copied or allocated individually.
+ */
+class FrameSeq {
+ public:
+  typedef Eigen::Map<const Eigen::VectorXd> ConstRow;
+  typedef Eigen::Map<Eigen::VectorXd> Row;
+
+  FrameSeq() {}
+  FrameSeq(const unsigned rows, const unsigned cols)
+      : block(RowMatrixXd::Zero(rows, cols)) {}
+
+  /** \brief Number of frames */
+  unsigned size() const { return (unsigned)block.rows(); }
+  /** \brief Values per frame */
+  unsigned cols() const { return (unsigned)block.cols(); }
+  bool empty() const { return block.rows() == 0; }
+
+  ConstRow operator[](const unsigned idx) const {
+    return ConstRow(row_data(idx), block.cols());
+  }
+  Row operator[](const unsigned idx) {
+    return Row(row_data(idx), block.cols());
+  }
+  const double *row_data(const unsigned idx) const {
+    return block.data() + (Eigen::Index)idx * block.cols();
+  }
+  double *row_data(const unsigned idx) {
+    return block.data() + (Eigen::Index)idx * block.cols();
+  }
+
+  /** \brief Resize (contents are zeroed) */
+  void resize(const unsigned rows, const unsigned cols) {
+    block = RowMatrixXd::Zero(rows, cols);
+  }
+  /** \brief Drop trailing frames (keeps existing rows) */
+  void truncate(const unsigned rows) {
+    if (rows < size()) block.conservativeResize(rows, Eigen::NoChange);
+  }
+
+  const RowMatrixXd &matrix() const { return block; }
+  RowMatrixXd &matrix() { return block; }
+
+ private:
+  RowMatrixXd block;
+};
+
 /** \brief Pipe input thru neural net matrices */
-std::vector<double> feedForward(Eigen::VectorXd &inputs,
-                                std::vector<Eigen::MatrixXd> &weights,
-                                std::vector<Eigen::VectorXd> &biases);
+std::vector<double> feedForward(
+    const Eigen::Ref<const Eigen::VectorXd> &inputs,
+    std::vector<Eigen::MatrixXd> &weights, std::vector<Eigen::VectorXd> &biases);
 
-/** \brief Get 1D eigen vector from input file */
+/**
+ * \brief Pipe every row of a sequence thru neural net matrices at once
+ * \param output Row i holds the prediction for inputs[i]
+ */
+void feedForward_batch(const FrameSeq &inputs,
+                       const std::vector<Eigen::MatrixXd> &weights,
+                       const std::vector<Eigen::VectorXd> &biases,
+                       RowMatrixXd &output);
+
+/**
+ * \brief Get 1D eigen vector from input file (empty if it has fewer values
+ * than its header says)
+ */
 Eigen::VectorXd extract_vector(const char *in_file);
 
-/** \brief Get vector of 1D eigen vector from input file */
-std::vector<Eigen::VectorXd> extract_vector2(const char *in_file,
-                                             const VectorOut type);
+/** \brief Get sequence of frames (1 per row) from input file */
+FrameSeq extract_vector2(const char *in_file, const VectorOut type);
+
+/**
+ * \brief Get only the named columns of a file w/ a header row
+ *
+ * Columns are resolved against the file's own header & returned in the
+ * order given. Other columns are skipped w/o being converted.
+ */
+FrameSeq extract_columns(const char *in_file, const char *const *columns,
+                         const unsigned num_columns);
 
-/** \brief Get 2D eigen matrix from input file */
+/**
+ * \brief Get 2D eigen matrix from input file (empty if it has fewer rows
+ * than its header says or a short row)
+ */
 Eigen::MatrixXd extract_matrix(const char *in_file);
 
 /** \brief Convert eigen vector to array of glm::vec3 */
-void get_points(std::vector<Eigen::VectorXd> &v_bin,
-                dd_array<glm::vec3> &out_bin, const unsigned idx,
-                const VectorOut type);
+void get_points(const FrameSeq &v_bin, dd_array<glm::vec3> &out_bin,
+                const unsigned idx, const VectorOut type);
 
 /** \brief Get calculated points */
-void get_points(Eigen::VectorXd &input, std::vector<Eigen::MatrixXd> &weights,
+void get_points(const Eigen::Ref<const Eigen::VectorXd> &input,
+                std::vector<Eigen::MatrixXd> &weights,
                 std::vector<Eigen::VectorXd> &biases,
                 dd_array<glm::vec3> &output);
 
+/** \brief Convert row of precomputed predictions to array of glm::vec3 */
+void get_points(const RowMatrixXd &v_bin, dd_array<glm::vec3> &out_bin,
+                const unsigned idx);
+
+/**
+ * \brief Euclidean error of every landmark in every frame
+ * \param out frames x landmarks (each column is 1 landmark over time)
+ *
+ * Predictions line up w/ the ground truth columns from the back (the normal
+ * model emits 4 leading values that aren't landmarks).
+ */
+void landmark_errors(const RowMatrixXd &predict, const RowMatrixXd &ground,
+                     Eigen::MatrixXf &out);
+
+/**
+ * \brief Grow box (min x, min y, max x, max y) by every point of a sequence
+ * \param skip Leading columns that aren't points (e.g. model outputs)
+ * \return false if the sequence holds no points
+ *
+ * Start from empty_bounds() to get the box of a single sequence.
+ */
+bool grow_bounds(const RowMatrixXd &rows, const unsigned skip,
+                 glm::vec4 &bounds);
+
+/** \brief Box w/ min > max that any point grows */
+inline glm::vec4 empty_bounds() {
+  return glm::vec4(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+}
+
+/** \brief Landmark names of registered keys (x columns w/o the " x") */
+std::vector<string64> landmark_names(const VectorOut type,
+                                     const unsigned landmarks);
+
 /** \brief Export data into calibrated space */
 void export_canonical_data(dd_array<glm::vec3> &input,
                            dd_array<glm::vec3> &ground, const char *dir,
@@ -39,10 +153,50 @@ void export_canonical_data(dd_array<glm::vec3> &input,
                            const glm::vec2 canonical_iris_pos,
                            const float canonical_iris_dist, const bool append);
 
-/** \brief Export data into calibrated space by folder */
+/**
+ * \brief Progress of a canonical export
+ *
+ * Written by export workers & polled by the UI. files is only valid once
+ * started is set, seconds only once finished is set.
+ */
+struct ExportProgress {
+  /** \brief State of a single subject file */
+  struct File {
+    string32 name;
+    std::atomic<unsigned> frames{0};
+    std::atomic<unsigned> frames_done{0};
+  };
+
+  std::vector<File> files;
+  std::atomic<unsigned> files_done{0};
+  std::atomic<unsigned long> frames_done{0};
+  unsigned threads = 0;
+  double seconds = 0.0;
+
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  /** \brief Set (w/ finished) if the input or ground folder can't be listed */
+  std::atomic<bool> failed{false};
+  /** \brief Set to stop export after files already in flight */
+  std::atomic<bool> cancel{false};
+};
+
+/**
+ * \brief Export data into calibrated space by folder
+ * \param num_threads Worker count (0 = 1 per hardware thread)
+ * \param progress Optional progress/cancel state shared w/ caller
+ */
 void export_canonical(const char *input_dir, const char *ground_dir,
                       const glm::vec2 canonical_iris_pos,
-                      const float canonical_iris_dist);
+                      const float canonical_iris_dist,
+                      const unsigned num_threads = 0,
+                      ExportProgress *progress = nullptr);
+
+/** \brief Column of header key (0 if not registered, thread safe) */
+unsigned find_key(const VectorOut type, const char *key);
+
+/** \brief Column of the time key (-1 if the header had none, thread safe) */
+int time_column(const VectorOut type);
 
 std::map<string64, unsigned> &get_input_keys();
 std::map<string64, unsigned> &get_output_keys();
@@ -0,0 +1,380 @@
+// Headless evaluation of the normal & canonical models over a whole corpus
+//
+// usage: smile_vis_eval [input dir] [ground dir] [weight dir] [bias dir]
+//                       [canon weight dir] [canon bias dir] [out prefix]
+//                       [threads]
+// (defaults to the bundled input/, ground_truth/, weight/, bias/,
+//  weight_canon/, bias_canon/, writes eval_landmarks.csv, eval_subjects.csv
+//  & eval.json, 0 threads = all cores)
+//
+// Every subject file is run through the normal model & (after moving it into
+// canonical space) through the canonical model. Canonical predictions are
+// mapped back to image space so both models report pixel errors.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "ddFileIO.h"
+#include "smile_vis_canon.h"
+#include "smile_vis_data.h"
+#include "smile_vis_mmap.h"
+
+namespace {
+typedef std::chrono::high_resolution_clock eval_clock;
+
+// same canonical space as the viewer & export
+const glm::vec2 canon_iris_pos(-0.5f, 0.f);
+const float canon_iris_dist = 1.f;
+
+const unsigned num_models = 2;
+const char *model_names[num_models] = {"normal", "canonical"};
+
+/** \brief Error distribution of a set of point distances (pixels) */
+struct ErrorStats {
+  unsigned long count = 0;
+  double mean = 0.0;
+  double rmse = 0.0;
+  double max = 0.0;
+  double p50 = 0.0;
+  double p90 = 0.0;
+  double p95 = 0.0;
+  double p99 = 0.0;
+};
+
+/** \brief Per frame & landmark errors of 1 subject file */
+struct FileResult {
+  string32 name;
+  unsigned frames = 0;
+  unsigned landmarks = 0;
+  bool valid[num_models] = {false, false};
+  // frames x landmarks
+  Eigen::MatrixXf errors[num_models];
+  size_t bytes = 0;
+};
+
+/** \brief Load w0..wN / b0..bN in layer order */
+bool load_model(const char *w_dir, const char *b_dir,
+                std::vector<Eigen::MatrixXd> &weights,
+                std::vector<Eigen::VectorXd> &biases) {
+  string512 w_file, b_file;
+  for (unsigned i = 0;; i++) {
+    w_file.format("%s/w%u.csv", w_dir, i);
+    b_file.format("%s/b%u.csv", b_dir, i);
+
+    ddIO probe;
+    if (!probe.open(w_file.str(), ddIOflag::READ)) break;
+
+    weights.push_back(extract_matrix(w_file.str()));
+    biases.push_back(extract_vector(b_file.str()));
+  }
+  return !weights.empty() && weights.size() == biases.size();
+}
+
+/** \brief Interleave PointSeq back into 1 row per frame */
+void to_frame_seq(const PointSeq &seq, FrameSeq &out) {
+  out.resize(seq.frames, seq.points * 2);
+  for (unsigned f = 0; f < seq.frames; f++) {
+    double *row = out.row_data(f);
+    for (unsigned p = 0; p < seq.points; p++) {
+      row[p * 2] = seq.x_track(p)[f];
+      row[p * 2 + 1] = seq.y_track(p)[f];
+    }
+  }
+}
+
+/** \brief Map canonical space rows back to image space (in place) */
+void from_canonical(const CanonTransforms &xforms, RowMatrixXd &rows) {
+  // inverse of [a b; -b a] is [a -b; b a] / (a^2 + b^2)
+  for (Eigen::Index f = 0; f < rows.rows(); f++) {
+    const double a = xforms.a[f], b = xforms.b[f];
+    const double inv = 1.0 / (a * a + b * b);
+    double *row = rows.data() + f * rows.cols();
+    for (Eigen::Index p = 0; p < rows.cols() / 2; p++) {
+      const double dx = row[p * 2] - xforms.tx[f];
+      const double dy = row[p * 2 + 1] - xforms.ty[f];
+      row[p * 2] = (a * dx - b * dy) * inv;
+      row[p * 2 + 1] = (b * dx + a * dy) * inv;
+    }
+  }
+}
+
+/** \brief Run both models over 1 input/ground truth pair */
+void evaluate_file(const char *in_file, const char *g_file,
+                   const std::vector<Eigen::MatrixXd> *weights,
+                   const std::vector<Eigen::VectorXd> *biases,
+                   FileResult &result) {
+  const FrameSeq input = extract_vector2(in_file, VectorOut::INPUT);
+  const FrameSeq ground = extract_vector2(g_file, VectorOut::OUTPUT);
+  FileStamp in_stamp, g_stamp;
+  get_file_stamp(in_file, in_stamp);
+  get_file_stamp(g_file, g_stamp);
+  result.bytes = in_stamp.size + g_stamp.size;
+  if (input.empty() || ground.empty()) {
+    fprintf(stderr, "Skipping %s: no frames\n", result.name.str());
+    return;
+  }
+
+  RowMatrixXd predict;
+  feedForward_batch(input, weights[0], biases[0], predict);
+  landmark_errors(predict, ground.matrix(), result.errors[0]);
+  result.frames = (unsigned)result.errors[0].rows();
+  result.landmarks = (unsigned)result.errors[0].cols();
+  result.valid[0] = result.frames > 0;
+
+  // canonical model sees input moved by the ground truth reference points
+  if (weights[1].empty() || input.size() != ground.size()) return;
+  PointSeq in_p, g_p;
+  CanonTransforms xforms;
+  to_point_seq(input.matrix(), in_p);
+  to_point_seq(ground.matrix(), g_p);
+  if (!canonicalize_sequence(in_p, g_p, canon_iris_pos, canon_iris_dist,
+                             xforms)) {
+    fprintf(stderr, "Skipping canonical %s: no reference points\n",
+            result.name.str());
+    return;
+  }
+  FrameSeq input_c;
+  to_frame_seq(in_p, input_c);
+  feedForward_batch(input_c, weights[1], biases[1], predict);
+  from_canonical(xforms, predict);
+  landmark_errors(predict, ground.matrix(), result.errors[1]);
+  result.valid[1] = result.errors[1].cols() == result.landmarks;
+}
+
+/** \brief Summarize distances (reorders errs) */
+ErrorStats summarize(std::vector<float> &errs) {
+  ErrorStats st;
+  st.count = errs.size();
+  if (errs.empty()) return st;
+
+  double sum = 0.0, sum_sq = 0.0;
+  for (size_t i = 0; i < errs.size(); i++) {
+    sum += errs[i];
+    sum_sq += (double)errs[i] * errs[i];
+  }
+  st.mean = sum / errs.size();
+  st.rmse = std::sqrt(sum_sq / errs.size());
+
+  std::sort(errs.begin(), errs.end());
+  st.max = errs.back();
+  // nearest rank percentiles
+  auto rank = [&errs](const double q) {
+    const size_t r = (size_t)std::ceil(q * errs.size());
+    return (double)errs[std::max<size_t>(r, 1) - 1];
+  };
+  st.p50 = rank(0.5);
+  st.p90 = rank(0.9);
+  st.p95 = rank(0.95);
+  st.p99 = rank(0.99);
+  return st;
+}
+
+void write_csv_row(FILE *out, const char *model, const char *name,
+                   const ErrorStats &st) {
+  fprintf(out, "%s,%s,%lu,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f\n", model, name,
+          st.count, st.mean, st.rmse, st.max, st.p50, st.p90, st.p95, st.p99);
+}
+
+void write_json_stats(FILE *out, const ErrorStats &st) {
+  fprintf(out,
+          "{\"count\": %lu, \"mean\": %.5f, \"rmse\": %.5f, \"max\": %.5f, "
+          "\"p50\": %.5f, \"p90\": %.5f, \"p95\": %.5f, \"p99\": %.5f}",
+          st.count, st.mean, st.rmse, st.max, st.p50, st.p90, st.p95, st.p99);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *in_dir = argc > 1 ? argv[1] : "input";
+  const char *g_dir = argc > 2 ? argv[2] : "ground_truth";
+  const char *w_dir = argc > 3 ? argv[3] : "weight";
+  const char *b_dir = argc > 4 ? argv[4] : "bias";
+  const char *wc_dir = argc > 5 ? argv[5] : "weight_canon";
+  const char *bc_dir = argc > 6 ? argv[6] : "bias_canon";
+  const char *out_prefix = argc > 7 ? argv[7] : "eval";
+  const unsigned num_threads = argc > 8 ? (unsigned)atoi(argv[8]) : 0;
+
+  std::vector<Eigen::MatrixXd> weights[num_models];
+  std::vector<Eigen::VectorXd> biases[num_models];
+  if (!load_model(w_dir, b_dir, weights[0], biases[0])) {
+    fprintf(stderr, "Failed to load model from %s & %s\n", w_dir, b_dir);
+    return 1;
+  }
+  if (!load_model(wc_dir, bc_dir, weights[1], biases[1])) {
+    fprintf(stderr, "No canonical model in %s & %s (skipping)\n", wc_dir,
+            bc_dir);
+    weights[1].clear();
+    biases[1].clear();
+  }
+
+  // subject files (exported canonical copies are recomputed, not read)
+  ddIO io_input;
+  if (!io_input.open(in_dir, ddIOflag::DIRECTORY)) {
+    fprintf(stderr, "Failed to open %s\n", in_dir);
+    return 1;
+  }
+  dd_array<string512> i_files = io_input.get_directory_files();
+  std::vector<string512> jobs;
+  std::vector<FileResult> results;
+  DD_FOREACH(string512, file, i_files) {
+    dd_array<unsigned> token_idx = StrLib::tokenize(file.ptr->str(), "\\/");
+    const string32 f_name = file.ptr->str(token_idx[token_idx.size() - 1] + 1);
+    if (!f_name.contains(".csv") || f_name.contains("canon")) continue;
+
+    jobs.push_back(*file.ptr);
+    results.push_back(FileResult());
+    results.back().name = f_name;
+  }
+  if (jobs.empty()) {
+    fprintf(stderr, "No input files in %s\n", in_dir);
+    return 1;
+  }
+
+  unsigned threads =
+      num_threads > 0 ? num_threads : std::thread::hardware_concurrency();
+  threads = std::max(1u, std::min(threads, (unsigned)jobs.size()));
+
+  // fixed pool pulls files off a shared counter
+  const eval_clock::time_point t_start = eval_clock::now();
+  std::atomic<unsigned> next_job(0);
+  auto worker = [&]() {
+    for (unsigned j = next_job++; j < jobs.size(); j = next_job++) {
+      string512 g_file;
+      g_file.format("%s/%s", g_dir, results[j].name.str());
+      evaluate_file(jobs[j].str(), g_file.str(), weights, biases, results[j]);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+  worker();
+  for (size_t t = 0; t < pool.size(); t++) pool[t].join();
+  const double seconds =
+      std::chrono::duration<double>(eval_clock::now() - t_start).count();
+
+  unsigned landmarks = 0;
+  unsigned long frames = 0;
+  size_t bytes = 0;
+  for (size_t r = 0; r < results.size(); r++) {
+    landmarks = std::max(landmarks, results[r].landmarks);
+    frames += results[r].frames;
+    bytes += results[r].bytes;
+  }
+  const std::vector<string64> names =
+      landmark_names(VectorOut::OUTPUT, landmarks);
+
+  // aggregate
+  ErrorStats overall[num_models];
+  std::vector<ErrorStats> by_landmark[num_models];
+  std::vector<ErrorStats> by_subject[num_models];
+  for (unsigned m = 0; m < num_models; m++) {
+    std::vector<float> all;
+    std::vector<std::vector<float>> per_landmark(landmarks);
+    by_subject[m].resize(results.size());
+    for (size_t r = 0; r < results.size(); r++) {
+      const FileResult &res = results[r];
+      if (!res.valid[m]) continue;
+      const Eigen::MatrixXf &errs = res.errors[m];
+      for (unsigned l = 0; l < res.landmarks; l++) {
+        per_landmark[l].insert(per_landmark[l].end(), errs.col(l).data(),
+                               errs.col(l).data() + errs.rows());
+      }
+      std::vector<float> subject(errs.data(), errs.data() + errs.size());
+      all.insert(all.end(), subject.begin(), subject.end());
+      by_subject[m][r] = summarize(subject);
+    }
+    overall[m] = summarize(all);
+    by_landmark[m].resize(landmarks);
+    for (unsigned l = 0; l < landmarks; l++) {
+      by_landmark[m][l] = summarize(per_landmark[l]);
+    }
+  }
+
+  // csv reports
+  string512 out_file;
+  out_file.format("%s_landmarks.csv", out_prefix);
+  FILE *out = fopen(out_file.str(), "w");
+  if (!out) {
+    fprintf(stderr, "Failed to write %s\n", out_file.str());
+    return 1;
+  }
+  fprintf(out, "model,landmark,count,mean,rmse,max,p50,p90,p95,p99\n");
+  for (unsigned m = 0; m < num_models; m++) {
+    if (overall[m].count == 0) continue;
+    write_csv_row(out, model_names[m], "all", overall[m]);
+    for (unsigned l = 0; l < landmarks; l++) {
+      write_csv_row(out, model_names[m], names[l].str(), by_landmark[m][l]);
+    }
+  }
+  fclose(out);
+
+  out_file.format("%s_subjects.csv", out_prefix);
+  out = fopen(out_file.str(), "w");
+  if (!out) {
+    fprintf(stderr, "Failed to write %s\n", out_file.str());
+    return 1;
+  }
+  fprintf(out, "model,subject,count,mean,rmse,max,p50,p90,p95,p99\n");
+  for (unsigned m = 0; m < num_models; m++) {
+    for (size_t r = 0; r < results.size(); r++) {
+      if (!results[r].valid[m]) continue;
+      write_csv_row(out, model_names[m], results[r].name.str(),
+                    by_subject[m][r]);
+    }
+  }
+  fclose(out);
+
+  // json report (same numbers + throughput)
+  out_file.format("%s.json", out_prefix);
+  out = fopen(out_file.str(), "w");
+  if (!out) {
+    fprintf(stderr, "Failed to write %s\n", out_file.str());
+    return 1;
+  }
+  fprintf(out,
+          "{\n  \"files\": %u,\n  \"frames\": %lu,\n  \"threads\": %u,\n"
+          "  \"seconds\": %.4f,\n  \"frames_per_second\": %.1f,\n"
+          "  \"mb_per_second\": %.2f,\n  \"models\": {",
+          (unsigned)results.size(), frames, threads, seconds,
+          frames / std::max(seconds, 1e-9),
+          bytes / (1024.0 * 1024.0) / std::max(seconds, 1e-9));
+  bool first_model = true;
+  for (unsigned m = 0; m < num_models; m++) {
+    if (overall[m].count == 0) continue;
+    fprintf(out, "%s\n    \"%s\": {\n      \"overall\": ",
+            first_model ? "" : ",", model_names[m]);
+    first_model = false;
+    write_json_stats(out, overall[m]);
+    fprintf(out, ",\n      \"landmarks\": {");
+    for (unsigned l = 0; l < landmarks; l++) {
+      fprintf(out, "%s\n        \"%s\": ", l ? "," : "", names[l].str());
+      write_json_stats(out, by_landmark[m][l]);
+    }
+    fprintf(out, "\n      },\n      \"subjects\": {");
+    bool first_subject = true;
+    for (size_t r = 0; r < results.size(); r++) {
+      if (!results[r].valid[m]) continue;
+      fprintf(out, "%s\n        \"%s\": ", first_subject ? "" : ",",
+              results[r].name.str());
+      first_subject = false;
+      write_json_stats(out, by_subject[m][r]);
+    }
+    fprintf(out, "\n      }\n    }");
+  }
+  fprintf(out, "\n  }\n}\n");
+  fclose(out);
+
+  printf("%u files, %lu frames in %.3f s (%u threads): %.0f frames/s, "
+         "%.1f MB/s\n",
+         (unsigned)results.size(), frames, seconds, threads,
+         frames / std::max(seconds, 1e-9),
+         bytes / (1024.0 * 1024.0) / std::max(seconds, 1e-9));
+  for (unsigned m = 0; m < num_models; m++) {
+    if (overall[m].count == 0) continue;
+    printf("%-10s mean %.3f px, rmse %.3f px, p95 %.3f px, max %.3f px\n",
+           model_names[m], overall[m].mean, overall[m].rmse, overall[m].p95,
+           overall[m].max);
+  }
+  printf("Wrote %s_landmarks.csv, %s_subjects.csv & %s.json\n", out_prefix,
+         out_prefix, out_prefix);
+  return 0;
+}
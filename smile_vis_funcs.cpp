@@ -1,6 +1,7 @@
 // level script for smile_vis cpp implementations
 #include "ddLevelPrototype.h"
 #include "smile_vis_graphics.h"
+#include "smile_vis_model.h"
 #include "svis_shader_enums.h"
 
 // log lua function that can be called in scripts thru this function
@@ -15,6 +16,9 @@ int log_data_groundtruth(lua_State *L);
 /** \brief Log smile data weights and biases truth */
 int log_data_weights_biases(lua_State *L);
 
+/** \brief Convert text weights and biases into binary model containers */
+int export_model_binary(lua_State *L);
+
 // Proxy struct that enables reflection
 struct smile_vis_reflect : public ddLvlPrototype {
   smile_vis_reflect() {
@@ -29,6 +33,7 @@ void smile_vis_func_register(lua_State *L) {
   register_callback_lua(L, "load_folder", load_smile_data);
   register_callback_lua(L, "groundtruth_folder", log_data_groundtruth);
   register_callback_lua(L, "w_b_folders", log_data_weights_biases);
+  register_callback_lua(L, "export_model", export_model_binary);
 
   register_lua_controller(L);
 }
@@ -56,17 +61,34 @@ int log_data_weights_biases(lua_State *L) {
   const char *directory1 = luaL_checkstring(L, 1);
   const char *directory2 = luaL_checkstring(L, 2);
 
-  load_weights(directory1);
-  load_biases(directory2);
+  load_model(0, directory1, directory2);
 	// canonical versions
-	string512 dir;
-	dir.format("%s_canon", directory1);
-	load_weights(dir.str());
-	dir.format("%s_canon", directory2);
-	load_biases(dir.str());
+	string512 dir1, dir2;
+	dir1.format("%s_canon", directory1);
+	dir2.format("%s_canon", directory2);
+	load_model(1, dir1.str(), dir2.str());
 
   return 0;
 }
 
+int export_model_binary(lua_State *L) {
+  // arguments are the same folders passed to w_b_folders
+  const char *directory1 = luaL_checkstring(L, 1);
+  const char *directory2 = luaL_checkstring(L, 2);
+
+  string512 out_file;
+  out_file.format("%s/%s", directory1, model_bin_name);
+  bool success = convert_model(directory1, directory2, out_file.str());
+  // canonical versions
+  string512 w_dir, b_dir;
+  w_dir.format("%s_canon", directory1);
+  b_dir.format("%s_canon", directory2);
+  out_file.format("%s/%s", w_dir.str(), model_bin_name);
+  success &= convert_model(w_dir.str(), b_dir.str(), out_file.str());
+
+  lua_pushboolean(L, success);
+  return 1;
+}
+
 // log reflection
 smile_vis_reflect smile_vis_proxy;
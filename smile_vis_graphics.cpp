@@ -1,9 +1,24 @@
 #include "smile_vis_graphics.h"
 #include "ddFileIO.h"
 #include "ddTerminal.h"
+#include "smile_vis_canon.h"
 #include "smile_vis_data.h"
+#include "smile_vis_model.h"
+#include "smile_vis_playback.h"
+#include "smile_vis_quant.h"
+#include "smile_vis_seqcache.h"
+#include "smile_vis_seqlru.h"
+#include "smile_vis_stats.h"
+#include "smile_vis_watch.h"
 #include "svis_shader_enums.h"
 #include "imgui_tabs.h"
+#include <atomic>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
 
 #define MAX_POINTS 4
 #define MAX_INDICES 8
@@ -12,7 +27,13 @@ struct SController {
   unsigned curr_idx = 0;
   unsigned num_frames = 0;
   float tile_size = 5.f;
+  // playback rate of sequences w/o a time column
+  float frame_rate = 20.f;
   glm::ivec4 ortho_params = glm::ivec4(0, 1920, 1080, 0);
+  // refit ortho_params to the bounds of every loaded sequence
+  bool auto_fit = false;
+  float fit_pad = 2.f;
+  glm::vec4 bounds = empty_bounds();
   dd_array<glm::vec3> _input;
   dd_array<glm::vec3> _ground;
   dd_array<glm::vec3> _predicted;
@@ -25,6 +46,7 @@ ddPTask draw_fdata;
 // shader for lines and points
 ddShader linedot_sh;
 ddShader point_sh;
+ddShader traj_sh;
 
 // line buffers
 ddVAOData *line_vao = nullptr;
@@ -51,29 +73,160 @@ glm::vec2 texcoord_buff[6];
 
 // point buffers
 ddVAOData *point_vao = nullptr;
-ddStorageBufferData *point_ssbo = nullptr;
+
+// trajectory overlay (segments index into the gpu sequence buffer)
+ddVAOData *traj_vao = nullptr;
+ddIndexBufferData *traj_ebo = nullptr;
+bool show_trajectories = false;
+int trail_frames = 0;
+
+// clear color of the render to texture pass (trails fade into it)
+const glm::vec4 background_color(0.5f, 0.5f, 0.5f, 1.f);
+
+/** \brief Landmark sets drawn by the point pass (in block order) */
+enum PointSet : unsigned { SET_INPUT = 0, SET_GROUND, SET_PREDICT, NUM_SETS };
+
+// per set point color (packed r | g << 8 | b << 16) & size scale
+const uint32_t set_colors[NUM_SETS] = {0xFFFFFF, 0x00FF00, 0x0000FF};
+const float set_scales[NUM_SETS] = {1.f, 1.f, 1.f};
+
+/**
+ * Every frame of the displayed sequence in 1 storage buffer
+ *
+ * Frame-major blocks of (input, ground truth, predicted, visible comparison
+ * model) points, each point a vec4 of (x, y, packed color, size scale) so 1
+ * draw covers all sets. Sets w/ fewer frames are padded w/ size 0 points the
+ * geometry shader drops. Only re-uploaded when the data or the displayed
+ * sets change, draws select the frame through their first vertex.
+ */
+struct GPUSequence {
+  ddStorageBufferData *ssbo = nullptr;
+  size_t capacity = 0;
+  unsigned frames = 0;
+  unsigned block_points = 0;
+  // which sources the buffer was built from (view/model selection)
+  unsigned layout = ~0u;
+  bool dirty = true;
+  std::vector<glm::vec4> staging;
+  // frame-major line segments (f, k) -> (f + 1, k) for the trajectory pass,
+  // so any frame range of every landmark is 1 contiguous index range
+  std::vector<unsigned> segments;
+  unsigned segment_frames = 0;
+  unsigned segment_block = 0;
+};
+GPUSequence gpu_seq;
+
+// time index & transport of the displayed sequence (drives curr_idx)
+Playback playback;
+// set if the index came from the capture's time column
+bool playback_timed = false;
+std::chrono::steady_clock::time_point playback_tick;
 
 // manipulatible frame data
 FrameData frames[2];
 SController sctrl;
 
-// data points of current visualization
-std::vector<Eigen::VectorXd> input_p;
+// displayed sequence (input & ground truth), shared w/ the sequence cache &
+// never modified
+std::shared_ptr<const LoadedSequence> loaded_p =
+    std::make_shared<const LoadedSequence>();
+
+// predictions shown for it (only the prediction fields are used): the loaded
+// sequence itself or a later recomputation (network output of both models &
+// every comparison model, per landmark/frame errors for the error timeline)
+std::shared_ptr<const LoadedSequence> predicted_p = loaded_p;
+
+// landmark names of the loaded sequence
+std::vector<string64> landmark_labels;
+// timeline series: per frame mean + 1 per landmark
+std::vector<const char *> error_items;
+int error_series = 0;
+bool error_bars = false;
+
+// normal tab data moved into canonical space on the fly (input, ground,
+// predicted)
+bool canon_view = false;
+PointSeq canon_view_p[3];
+
+// background load of the selected sequence (swapped in once complete)
+std::future<std::shared_ptr<const LoadedSequence>> async_load;
+std::atomic<unsigned> load_stage(0);
+const unsigned num_load_stages = 3;
+string32 loading_name;
+// set when the active sequence came from the canonical tab
+bool loaded_canonical = false;
+
+// recently loaded sequences & background prefetch of list neighbours
+SequenceLRU seq_cache;
+int cache_budget_mb = 256;
+std::future<void> async_prefetch;
+// bumped when weights change so in-flight loads don't cache stale predictions
+std::atomic<unsigned> model_generation(0);
+
+// normal & canonical model in use (only swapped between frames) & the
+// folders they are loaded from
+std::shared_ptr<const ModelLayers> models[2] = {
+    std::make_shared<const ModelLayers>(),
+    std::make_shared<const ModelLayers>()};
+ModelSource model_src[2];
+
+/** \brief Extra named model overlaid on the sequence in its own color */
+struct CompareModel {
+  string32 name;
+  ModelSource source;
+  // packed r | g << 8 | b << 16 (as set_colors)
+  uint32_t color = 0;
+  bool visible = true;
+};
 
-// data points of ground truth
-std::vector<Eigen::VectorXd> groundtr_p;
+// comparison models (evaluated in the same pass as the normal/canonical
+// pair) & the layers in use (same order, swapped w/ models)
+std::vector<std::unique_ptr<CompareModel>> compare_models;
+std::vector<std::shared_ptr<const ModelLayers>> compare_layers;
+// colors of models added w/o one
+const uint32_t compare_palette[5] = {0x00A5FF, 0xFF00FF, 0xFFFF00, 0x00FFFF,
+                                     0xFF0080};
+
+/** \brief Models run by 1 prediction pass (held by workers while swapped) */
+struct ModelSet {
+  std::shared_ptr<const ModelLayers> pair[2];
+  std::vector<std::shared_ptr<const ModelLayers>> compare;
+};
 
-// weights and biases
-std::vector<Eigen::MatrixXd> weights;
-std::vector<Eigen::VectorXd> biases;
-std::vector<Eigen::MatrixXd> weights_canon;
-std::vector<Eigen::VectorXd> biases_canon;
+// model folder changes are reloaded once writes settle (retraining writes
+// layer by layer)
+DirWatcher model_watch;
+bool model_changed = false;
+std::chrono::steady_clock::time_point model_change_time;
+const std::chrono::milliseconds model_settle(300);
+std::future<bool> async_reload;
+
+// predictions of the displayed sequence recomputed after a model swap
+std::future<std::unique_ptr<LoadedSequence>> async_predict;
+bool repredict_pending = false;
+// bumped whenever a new sequence is swapped in (stale results are dropped)
+unsigned sequence_id = 0;
+unsigned repredict_id = 0;
 
 // int buffer for pulling values from lua
 dd_array<int64_t> i64_bin = dd_array<int64_t>(4);
 
 // asynchronous function for exporting input
 std::future<void> async_canonical;
+// export worker count & progress of the current/last export
+int export_threads = std::max(1, (int)std::thread::hardware_concurrency());
+std::unique_ptr<ExportProgress> export_progress;
+
+// numeric backend used for predictions (InferenceMode)
+int infer_mode = 0;
+
+// asynchronous backend accuracy report over all_data/
+std::future<std::vector<AccuracyStats>> async_accuracy;
+std::vector<AccuracyStats> accuracy_stats;
+
+// timer/counter window & trace file written by its save button
+bool show_stats_overlay = false;
+string512 trace_file = "smile_vis_trace.json";
 
 // tab bar controls
 const char *tab_name[2] = {"Normal", "Canonical"};
@@ -89,7 +242,28 @@ bool tab_flag[2] = {true, true};
 const size_t idx_var = StrLib::get_char_hash("idx");
 const size_t frames_var = StrLib::get_char_hash("num_frames");
 const size_t tile_var = StrLib::get_char_hash("tile");
+const size_t fps_var = StrLib::get_char_hash("fps");
 const size_t ortho_var = StrLib::get_char_hash("ortho");
+const size_t auto_fit_var = StrLib::get_char_hash("auto_fit");
+const size_t fit_pad_var = StrLib::get_char_hash("fit_pad");
+const size_t bounds_var = StrLib::get_char_hash("bounds");
+
+/** \brief Rebuild time index of the displayed sequence (restarts clock) */
+void build_playback_index();
+
+/** \brief Move playback (& the displayed frame) to frame */
+void seek_frame(const unsigned frame);
+
+/** \brief Fit orthographic view to sequence bounds (+ padding) */
+void fit_ortho(SController &ctrl) {
+  if (ctrl.bounds.x > ctrl.bounds.z) return;
+  // y axis points down (top is the smaller value)
+  ctrl.ortho_params = glm::ivec4(
+      (int)std::floor(ctrl.bounds.x - ctrl.fit_pad),
+      (int)std::ceil(ctrl.bounds.z + ctrl.fit_pad),
+      (int)std::ceil(ctrl.bounds.w + ctrl.fit_pad),
+      (int)std::floor(ctrl.bounds.y - ctrl.fit_pad));
+}
 
 static int set_val(lua_State *L) {
   SController *ctrl = *check_sctrl(L);
@@ -102,7 +276,7 @@ static int set_val(lua_State *L) {
 
     if (arg_name.gethash() == idx_var) {
       // set current frame
-      ctrl->curr_idx = luaL_checkinteger(L, 3);
+      seek_frame((unsigned)luaL_checkinteger(L, 3));
     } else if (arg_name.gethash() == ortho_var) {
       // set orthographic matric params
       read_buffer_from_lua(L, i64_bin);
@@ -112,6 +286,15 @@ static int set_val(lua_State *L) {
       ctrl->ortho_params.w = i64_bin[3];
     } else if (arg_name.gethash() == tile_var) {
       ctrl->tile_size = luaL_checknumber(L, 3);
+    } else if (arg_name.gethash() == fps_var) {
+      ctrl->frame_rate = luaL_checknumber(L, 3);
+      build_playback_index();
+    } else if (arg_name.gethash() == auto_fit_var) {
+      ctrl->auto_fit = lua_toboolean(L, 3) != 0;
+      if (ctrl->auto_fit) fit_ortho(*ctrl);
+    } else if (arg_name.gethash() == fit_pad_var) {
+      ctrl->fit_pad = luaL_checknumber(L, 3);
+      if (ctrl->auto_fit) fit_ortho(*ctrl);
     }
   }
   return 0;
@@ -130,6 +313,15 @@ static int get_val(lua_State *L) {
   } else if (arg_name.gethash() == ortho_var) {
     push_ivec4_to_lua(L, ctrl->ortho_params.x, ctrl->ortho_params.y,
                       ctrl->ortho_params.y, ctrl->ortho_params.z);
+  } else if (arg_name.gethash() == fps_var) {
+    lua_pushnumber(L, ctrl->frame_rate);
+  } else if (arg_name.gethash() == auto_fit_var) {
+    lua_pushboolean(L, ctrl->auto_fit);
+  } else if (arg_name.gethash() == fit_pad_var) {
+    lua_pushnumber(L, ctrl->fit_pad);
+  } else if (arg_name.gethash() == bounds_var) {
+    push_vec4_to_lua(L, ctrl->bounds.x, ctrl->bounds.y, ctrl->bounds.z,
+                     ctrl->bounds.w);
   }
 
   return 1;
@@ -187,11 +379,422 @@ static int get_calc_data(lua_State *L) {
   return sctrl._predicted.size();
 }
 
+//******************************************************************************
+//******************************************************************************
+
+#define SVIEW_META_NAME "LuaClass.SeqView"
+#define check_sview(L) (SeqView *)luaL_checkudata(L, 1, SVIEW_META_NAME)
+
+/** \brief Loaded buffers a view can point at */
+enum ViewSource : unsigned {
+  VIEW_INPUT = 0,
+  VIEW_GROUND,
+  VIEW_PREDICT,         // model of the active tab (as drawn)
+  VIEW_PREDICT_NORMAL,  // normal model
+  VIEW_PREDICT_CANON,   // canonical model
+  NUM_VIEW_SOURCES
+};
+const char *view_source_names[NUM_VIEW_SOURCES] = {
+    "input", "ground", "predict", "predict_normal", "predict_canon"};
+
+/**
+ * Lua handle on a frame range of 1 loaded buffer
+ *
+ * Holds no data: the buffer & range are resolved on every access, so a view
+ * stays valid (& follows the data) when another sequence is loaded. Values
+ * are the flat frame-major (x, y) pairs of the range.
+ */
+struct SeqView {
+  unsigned source = VIEW_INPUT;
+  unsigned first = 0;
+  unsigned count = 0;  // 0: up to the last frame
+};
+
+/** \brief Resolved view (columns starts at 1st landmark of the range) */
+struct ViewBlock {
+  const double *data = nullptr;
+  unsigned frames = 0;
+  unsigned cols = 0;
+  unsigned stride = 0;
+
+  unsigned size() const { return frames * cols; }
+  double at(const unsigned i) const {
+    return data[(size_t)(i / cols) * stride + i % cols];
+  }
+};
+
+ViewBlock resolve_view(const SeqView &view) {
+  const RowMatrixXd *mat = nullptr;
+  unsigned skip = 0;
+  switch (view.source) {
+    case VIEW_INPUT:
+      mat = &loaded_p->input.matrix();
+      break;
+    case VIEW_GROUND:
+      mat = &loaded_p->ground.matrix();
+      break;
+    default: {
+      const unsigned m = view.source == VIEW_PREDICT
+                             ? (tab_flag[0] ? 0 : 1)
+                             : view.source - VIEW_PREDICT_NORMAL;
+      mat = &predicted_p->predict[m];
+      // leading non-landmark outputs (predictions line up w/ ground truth
+      // from the back)
+      const long g_cols = loaded_p->ground.cols();
+      if (g_cols > 0 && mat->cols() > g_cols) {
+        skip = (unsigned)(mat->cols() - g_cols);
+      }
+      break;
+    }
+  }
+
+  ViewBlock out;
+  const unsigned rows = (unsigned)mat->rows();
+  if (view.first >= rows || mat->cols() <= skip) return out;
+  out.frames = view.count > 0 ? std::min(view.count, rows - view.first)
+                              : rows - view.first;
+  out.stride = (unsigned)mat->cols();
+  out.cols = (out.stride - skip) & ~1u;
+  out.data = mat->data() + (size_t)view.first * out.stride + skip;
+  return out;
+}
+
+/** \brief x (column 0) or y (column 1) of every point in the block */
+Eigen::Map<const RowMatrixXd, 0, Eigen::Stride<Eigen::Dynamic, 2>> view_axis(
+    const ViewBlock &block, const unsigned axis) {
+  return Eigen::Map<const RowMatrixXd, 0, Eigen::Stride<Eigen::Dynamic, 2>>(
+      block.data + axis, block.frames, block.cols / 2,
+      Eigen::Stride<Eigen::Dynamic, 2>(block.stride, 2));
+}
+
+/** \brief SController.view(source [, first frame [, frames]]) */
+static int new_view(lua_State *L) {
+  const char *name = luaL_optstring(L, 1, "input");
+  unsigned source = NUM_VIEW_SOURCES;
+  for (unsigned i = 0; i < NUM_VIEW_SOURCES; i++) {
+    if (std::strcmp(name, view_source_names[i]) == 0) source = i;
+  }
+  if (source == NUM_VIEW_SOURCES) {
+    return luaL_argerror(L, 1, "expected input, ground, predict, "
+                               "predict_normal or predict_canon");
+  }
+
+  SeqView *view = (SeqView *)lua_newuserdata(L, sizeof(SeqView));
+  view->source = source;
+  view->first = (unsigned)std::max((lua_Integer)0, luaL_optinteger(L, 2, 0));
+  view->count = (unsigned)std::max((lua_Integer)0, luaL_optinteger(L, 3, 0));
+
+  luaL_getmetatable(L, SVIEW_META_NAME);
+  lua_setmetatable(L, -2);
+  return 1;
+}
+
+static int view_frames(lua_State *L) {
+  lua_pushinteger(L, resolve_view(*check_sview(L)).frames);
+  return 1;
+}
+
+static int view_points(lua_State *L) {
+  lua_pushinteger(L, resolve_view(*check_sview(L)).cols / 2);
+  return 1;
+}
+
+/** \brief view:get(frame, point) -> x, y (0 based, relative to the view) */
+static int view_get(lua_State *L) {
+  const ViewBlock block = resolve_view(*check_sview(L));
+  const lua_Integer f = luaL_checkinteger(L, 2);
+  const lua_Integer p = luaL_checkinteger(L, 3);
+  if (f < 0 || p < 0 || f >= block.frames || p >= block.cols / 2) return 0;
+  const double *point = block.data + (size_t)f * block.stride + p * 2;
+  lua_pushnumber(L, point[0]);
+  lua_pushnumber(L, point[1]);
+  return 2;
+}
+
+static int view_min(lua_State *L) {
+  const ViewBlock block = resolve_view(*check_sview(L));
+  if (block.size() == 0) return 0;
+  lua_pushnumber(L, view_axis(block, 0).minCoeff());
+  lua_pushnumber(L, view_axis(block, 1).minCoeff());
+  return 2;
+}
+
+static int view_max(lua_State *L) {
+  const ViewBlock block = resolve_view(*check_sview(L));
+  if (block.size() == 0) return 0;
+  lua_pushnumber(L, view_axis(block, 0).maxCoeff());
+  lua_pushnumber(L, view_axis(block, 1).maxCoeff());
+  return 2;
+}
+
+static int view_mean(lua_State *L) {
+  const ViewBlock block = resolve_view(*check_sview(L));
+  if (block.size() == 0) return 0;
+  lua_pushnumber(L, view_axis(block, 0).mean());
+  lua_pushnumber(L, view_axis(block, 1).mean());
+  return 2;
+}
+
+/** \brief view:bounds() -> min x, min y, max x, max y */
+static int view_bounds(lua_State *L) {
+  const ViewBlock block = resolve_view(*check_sview(L));
+  if (block.size() == 0) return 0;
+  lua_pushnumber(L, view_axis(block, 0).minCoeff());
+  lua_pushnumber(L, view_axis(block, 1).minCoeff());
+  lua_pushnumber(L, view_axis(block, 0).maxCoeff());
+  lua_pushnumber(L, view_axis(block, 1).maxCoeff());
+  return 4;
+}
+
+static const struct luaL_Reg sview_funcs[] = {
+    {"frames", view_frames}, {"points", view_points}, {"get", view_get},
+    {"min", view_min},       {"max", view_max},       {"mean", view_mean},
+    {"bounds", view_bounds}, {NULL, NULL}};
+
+/** \brief view[i] (1 based flat value) or method lookup */
+static int view_index(lua_State *L) {
+  const SeqView *view = check_sview(L);
+  if (lua_isnumber(L, 2)) {
+    const ViewBlock block = resolve_view(*view);
+    const lua_Integer i = luaL_checkinteger(L, 2);
+    if (i < 1 || i > block.size()) {
+      lua_pushnil(L);
+    } else {
+      lua_pushnumber(L, block.at((unsigned)(i - 1)));
+    }
+    return 1;
+  }
+
+  const char *key = luaL_checkstring(L, 2);
+  for (const luaL_Reg *func = sview_funcs; func->name; func++) {
+    if (std::strcmp(key, func->name) == 0) {
+      lua_pushcfunction(L, func->func);
+      return 1;
+    }
+  }
+  lua_pushnil(L);
+  return 1;
+}
+
+static int view_len(lua_State *L) {
+  lua_pushinteger(L, resolve_view(*check_sview(L)).size());
+  return 1;
+}
+
+static int view_to_string(lua_State *L) {
+  const SeqView *view = check_sview(L);
+  const ViewBlock block = resolve_view(*view);
+  string64 out;
+  out.format("SeqView(%s, frames %u-%u, %u points)",
+             view_source_names[view->source], view->first,
+             view->first + block.frames, block.cols / 2);
+  lua_pushstring(L, out.str());
+  return 1;
+}
+
+static const struct luaL_Reg sview_methods[] = {{"__index", view_index},
+                                                {"__len", view_len},
+                                                {"__tostring", view_to_string},
+                                                {NULL, NULL}};
+
+//******************************************************************************
+//******************************************************************************
+
+/** \brief SController.play([flag]) (default true) */
+static int play(lua_State *L) {
+  playback.playing = lua_isnoneornil(L, 1) || lua_toboolean(L, 1) != 0;
+  return 0;
+}
+
+static int pause(lua_State *L) {
+  playback.playing = false;
+  return 0;
+}
+
+/** \brief SController.step([frames]) (default 1, pauses) */
+static int step(lua_State *L) {
+  playback.step((int)luaL_optinteger(L, 1, 1));
+  sctrl.curr_idx = playback.sample().frame;
+  return 0;
+}
+
+/** \brief SController.seek(seconds of capture time) */
+static int seek(lua_State *L) {
+  playback.seek(luaL_checknumber(L, 1));
+  sctrl.curr_idx = playback.sample().frame;
+  return 0;
+}
+
+/** \brief SController.set_mode("real-time" | "scaled" | "step") */
+static int set_mode(lua_State *L) {
+  const char *name = luaL_checkstring(L, 1);
+  for (unsigned i = 0; i < (unsigned)PlayMode::COUNT; i++) {
+    if (std::strcmp(name, play_mode_names[i]) == 0) {
+      playback.mode = (PlayMode)i;
+      return 0;
+    }
+  }
+  return luaL_argerror(L, 1, "expected real-time, scaled or step");
+}
+
+/** \brief SController.set_speed(factor) (switches to scaled mode) */
+static int set_speed(lua_State *L) {
+  playback.speed = (float)luaL_checknumber(L, 1);
+  playback.mode = PlayMode::SCALED;
+  return 0;
+}
+
+/** \brief Transport state: {time, duration, frame, frames, playing, mode,
+ * speed, timed} */
+static int get_playback(lua_State *L) {
+  lua_createtable(L, 0, 8);
+  lua_pushnumber(L, playback.time());
+  lua_setfield(L, -2, "time");
+  lua_pushnumber(L, playback.duration());
+  lua_setfield(L, -2, "duration");
+  lua_pushinteger(L, playback.sample().frame);
+  lua_setfield(L, -2, "frame");
+  lua_pushinteger(L, playback.frames());
+  lua_setfield(L, -2, "frames");
+  lua_pushboolean(L, playback.playing);
+  lua_setfield(L, -2, "playing");
+  lua_pushstring(L, play_mode_names[(unsigned)playback.mode]);
+  lua_setfield(L, -2, "mode");
+  lua_pushnumber(L, playback.speed);
+  lua_setfield(L, -2, "speed");
+  lua_pushboolean(L, playback_timed);
+  lua_setfield(L, -2, "timed");
+  return 1;
+}
+
+/** \brief Table of timers: name -> {calls, total_ms, avg_ms, max_ms, bytes} */
+static int get_stats(lua_State *L) {
+  const std::vector<StatSnapshot> snap = stats_snapshot();
+  lua_createtable(L, 0, (int)snap.size());
+  for (size_t i = 0; i < snap.size(); i++) {
+    lua_createtable(L, 0, 5);
+    lua_pushinteger(L, (lua_Integer)snap[i].calls);
+    lua_setfield(L, -2, "calls");
+    lua_pushnumber(L, snap[i].total_ms);
+    lua_setfield(L, -2, "total_ms");
+    lua_pushnumber(L, snap[i].avg_ms);
+    lua_setfield(L, -2, "avg_ms");
+    lua_pushnumber(L, snap[i].max_ms);
+    lua_setfield(L, -2, "max_ms");
+    lua_pushinteger(L, (lua_Integer)snap[i].bytes);
+    lua_setfield(L, -2, "bytes");
+    lua_setfield(L, -2, snap[i].name.str());
+  }
+  return 1;
+}
+
+static int reset_stats(lua_State *L) {
+  stats_reset();
+  return 0;
+}
+
+/** \brief Switch collection on/off (no argument: query) */
+static int enable_stats(lua_State *L) {
+  if (!lua_isnoneornil(L, 1)) set_stats_enabled(lua_toboolean(L, 1) != 0);
+  lua_pushboolean(L, stats_enabled());
+  return 1;
+}
+
+static int start_trace(lua_State *L) {
+  trace_start();
+  return 0;
+}
+
+/** \brief Stop recording & write trace (optional file name) */
+static int save_trace(lua_State *L) {
+  const char *file = luaL_optstring(L, 1, trace_file.str());
+  trace_stop();
+  const bool saved = trace_save(file);
+  if (!saved) ddTerminal::f_post("[error]Can't write trace: %s", file);
+  lua_pushboolean(L, saved);
+  return 1;
+}
+
+/** \brief SController.add_model(name, weight_dir, bias_dir [, r, g, b])
+ * (color 0-1, default from palette) */
+static int add_model(lua_State *L) {
+  const char *name = luaL_checkstring(L, 1);
+  const char *weight_dir = luaL_checkstring(L, 2);
+  const char *bias_dir = luaL_checkstring(L, 3);
+  const size_t palette_size = sizeof(compare_palette) / sizeof(uint32_t);
+  uint32_t color = compare_palette[compare_models.size() % palette_size];
+  if (!lua_isnoneornil(L, 4)) {
+    color = 0;
+    for (int i = 0; i < 3; i++) {
+      const double c =
+          std::min(1.0, std::max(0.0, luaL_checknumber(L, 4 + i)));
+      color |= (uint32_t)(c * 255.0 + 0.5) << (i * 8);
+    }
+  }
+  lua_pushboolean(L, add_compare_model(name, weight_dir, bias_dir, color));
+  return 1;
+}
+
+static int remove_model(lua_State *L) {
+  lua_pushboolean(L, remove_compare_model(luaL_checkstring(L, 1)));
+  return 1;
+}
+
+/** \brief SController.show_model(name, visible) */
+static int show_model(lua_State *L) {
+  const char *name = luaL_checkstring(L, 1);
+  for (const std::unique_ptr<CompareModel> &c : compare_models) {
+    if (std::strcmp(c->name.str(), name) != 0) continue;
+    c->visible = lua_toboolean(L, 2) != 0;
+    gpu_seq.dirty = true;
+  }
+  return 0;
+}
+
+/** \brief Comparison models: {{name, layers, visible, error}, ...} (error of
+ * the displayed sequence, -1 if unknown) */
+static int get_models(lua_State *L) {
+  lua_createtable(L, (int)compare_models.size(), 0);
+  for (size_t c = 0; c < compare_models.size(); c++) {
+    lua_createtable(L, 0, 4);
+    lua_pushstring(L, compare_models[c]->name.str());
+    lua_setfield(L, -2, "name");
+    lua_pushinteger(L, c < compare_layers.size()
+                           ? (lua_Integer)compare_layers[c]->num_layers()
+                           : 0);
+    lua_setfield(L, -2, "layers");
+    lua_pushboolean(L, compare_models[c]->visible);
+    lua_setfield(L, -2, "visible");
+    const std::vector<float> &errors = predicted_p->compare_error;
+    lua_pushnumber(L, c < errors.size() ? errors[c] : -1.f);
+    lua_setfield(L, -2, "error");
+    lua_rawseti(L, -2, (int)c + 1);
+  }
+  return 1;
+}
+
 static const struct luaL_Reg sctrl_lib[] = {
     {"get", get_sctrl},
     {"get_input_data", get_input_data},
     {"get_ground_data", get_ground_data},
     {"get_calc_data", get_calc_data},
+    {"view", new_view},
+    {"play", play},
+    {"pause", pause},
+    {"step", step},
+    {"seek", seek},
+    {"set_mode", set_mode},
+    {"set_speed", set_speed},
+    {"playback", get_playback},
+    {"stats", get_stats},
+    {"stats_reset", reset_stats},
+    {"stats_enable", enable_stats},
+    {"trace_start", start_trace},
+    {"trace_save", save_trace},
+    {"add_model", add_model},
+    {"remove_model", remove_model},
+    {"show_model", show_model},
+    {"models", get_models},
     {NULL, NULL}};
 
 int luaopen_sctrl(lua_State *L) {
@@ -201,6 +804,11 @@ int luaopen_sctrl(lua_State *L) {
   lua_setfield(L, -2, "__index");        /* mt.__index = mt */
   luaL_setfuncs(L, sctrl_methods, 0);    /* register metamethods */
 
+  // sequence views resolve methods & numeric keys in __index
+  luaL_newmetatable(L, SVIEW_META_NAME);
+  luaL_setfuncs(L, sview_methods, 0);
+  lua_pop(L, 1);
+
   // library functions
   luaL_newlib(L, sctrl_lib);
   return 1;
@@ -220,6 +828,15 @@ void register_lua_controller(lua_State *L) {
 /** \brief Draws FrameData for particle task */
 void draw_frame();
 
+/** \brief Timer/counter window w/ trace controls */
+void show_stats();
+
+/** \brief Advance playback by wall clock time since the last call */
+void update_playback();
+
+/** \brief Transport controls */
+void show_playback();
+
 /** \brief initilize data strutures for level */
 void init_data();
 
@@ -229,6 +846,93 @@ void refill_buffer(const FrameData &data);
 /** \brief Set ImGUI style */
 void set_imgui_style();
 
+/** \brief Run backend over every frame of a sequence */
+void predict_sequence(const FrameSeq &input, const ModelLayers &model,
+                      const InferenceMode mode, RowMatrixXd &out);
+
+/** \brief Models currently in use (pair & comparison models) */
+ModelSet models_in_use();
+
+/**
+ * \brief Run every model of the set over a sequence
+ * \param predict Normal & canonical model output
+ * \param compare Output per comparison model
+ *
+ * The double backend evaluates all models in 1 pass w/ a shared 1st layer
+ * GEMM (feedForward_models, cost still ~linear in the model count). The
+ * float32/int8 backends have no batched path & run model by model, frame
+ * by frame.
+ */
+void predict_models(const ModelSet &m, const FrameSeq &input,
+                    const InferenceMode mode, RowMatrixXd *predict,
+                    std::vector<RowMatrixXd> &compare);
+
+/** \brief Mean landmark error of each comparison model (-1: no output) */
+void compare_errors(const std::vector<RowMatrixXd> &compare,
+                    const FrameSeq &ground, std::vector<float> &out);
+
+/** \brief Prediction errors of both models vs ground truth (+ frame means) */
+void sequence_errors(const RowMatrixXd *predict, const FrameSeq &ground,
+                     Eigen::MatrixXf *errors, Eigen::VectorXf *frame_error);
+
+/** \brief Scrubbable error timeline & per landmark errors of current frame */
+void show_error_timeline();
+
+/** \brief Show progress of running/last canonical export */
+void show_export_progress();
+
+/** \brief Rebuild canonical view of loaded sequence (if enabled) */
+void refresh_canon_view();
+
+/** \brief Parse input & ground truth files & predict on a worker thread */
+void start_sequence_load(const char *in_file, const char *g_file,
+                         const char *name, const bool canonical);
+
+/** \brief Swap in a finished background load (call once per frame) */
+void poll_sequence_load();
+
+/** \brief Load files next to the selection into the cache in the background */
+void start_prefetch(const bool canonical);
+
+/** \brief Sequence cache budget & counters */
+void show_cache_stats();
+
+/**
+ * \brief Rebuild & upload gpu sequence buffer if data or layout changed
+ * \param layout bit 0: canonical view, bit 1: view predictions,
+ *               bit 2: canonical model predictions
+ */
+void upload_sequence(const unsigned layout);
+
+/** \brief Draw every landmark set of 1 frame in a single call */
+bool draw_sequence_points(const unsigned frame, const float blend);
+
+/** \brief Draw landmark trajectories (whole sequence or trail up to frame) */
+void draw_trajectories(const glm::mat4 &mvp, const unsigned frame);
+
+/** \brief Box around input, ground truth & predictions of 1 model */
+glm::vec4 sequence_bounds(const FrameSeq &input, const FrameSeq &ground,
+                          const RowMatrixXd &predict);
+
+/** \brief Progress bar of running background load */
+void show_load_progress();
+
+/** \brief Comparison model list (visibility & error on loaded sequence) */
+void show_compare_models();
+
+/** \brief Reload changed model folders, swap in new models & background
+ * predictions (once per frame) */
+void poll_model_reload();
+
+/** \brief Use latest models of all sources & recompute predictions */
+void swap_models();
+
+/** \brief Watch folders of the model pair & every comparison model */
+void watch_model_folders();
+
+/** \brief Recompute predictions of displayed sequence in the background */
+void start_repredict();
+
 int init_gpu_structures(lua_State *L) {
   // indices buffer
   l_indices[0] = 0;
@@ -260,6 +964,12 @@ int init_gpu_structures(lua_State *L) {
   fname.format("%s/smile_vis/%s", PROJECT_DIR, "PointRend_F.frag");
   point_sh.create_frag_shader(fname.str());
 
+  traj_sh.init();
+  fname.format("%s/smile_vis/%s", PROJECT_DIR, "Trajectory_V.vert");
+  traj_sh.create_vert_shader(fname.str());
+  fname.format("%s/smile_vis/%s", PROJECT_DIR, "Trajectory_F.frag");
+  traj_sh.create_frag_shader(fname.str());
+
   // line structures
   ddGPUFrontEnd::create_vao(line_vao);
   ddGPUFrontEnd::create_storage_buffer(line_ssbo, l_points.sizeInBytes());
@@ -272,9 +982,9 @@ int init_gpu_structures(lua_State *L) {
                                              0, &l_points[0]);
   ddGPUFrontEnd::bind_index_buffer(line_vao, line_ebo);
 
-  // point structures
+  // point structures (storage buffer is sized on 1st sequence upload)
   ddGPUFrontEnd::create_vao(point_vao);
-  ddGPUFrontEnd::create_storage_buffer(point_ssbo, 50 * 3 * sizeof(float));
+  ddGPUFrontEnd::create_vao(traj_vao);
 
   // register particle task
   draw_fdata.lifespan = 10.f;
@@ -314,6 +1024,7 @@ void update_frame_data(const FrameData &data) { refill_buffer(data); }
 
 /** \brief Draws FrameData for gpu */
 void draw_frame() {
+  SVIS_SCOPE("draw_frame");
   ddCam *cam = ddSceneManager::get_active_cam();
   const glm::mat4 identity;
   const glm::uvec2 scr_dim = ddSceneManager::get_screen_dimensions();
@@ -325,11 +1036,35 @@ void draw_frame() {
     ddGPUFrontEnd::bind_framebuffer(ddBufferType::XTRA);
     ddGPUFrontEnd::clear_color_buffer();
 
-    // data vector
-    if (input_p.size() > 0) {
-      get_points(input_p, sctrl._input, sctrl.curr_idx, VectorOut::INPUT);
-      ddGPUFrontEnd::set_storage_buffer_contents(
-          point_ssbo, sctrl._input.sizeInBytes(), 0, &sctrl._input[0]);
+    // normal tab can show the sequence in canonical space
+    const bool use_view = canon_view && tab_flag[0] && canon_view_p[0].frames;
+
+
+    // current frame on the cpu side (ui & lua queries)
+    if (loaded_p->input.size() > 0) {
+      if (use_view) {
+        get_points(canon_view_p[0], sctrl._input, sctrl.curr_idx);
+        get_points(canon_view_p[1], sctrl._ground, sctrl.curr_idx);
+      } else {
+        get_points(loaded_p->input, sctrl._input, sctrl.curr_idx,
+                   VectorOut::INPUT);
+        get_points(loaded_p->ground, sctrl._ground, sctrl.curr_idx,
+                   VectorOut::OUTPUT);
+      }
+    }
+    const unsigned model_idx = tab_flag[0] ? 0 : 1;
+    const bool view_predict = use_view && canon_view_p[2].frames;
+
+    // upload only happens after load/backend/view/tab changes
+    upload_sequence((use_view ? 1u : 0u) | (view_predict ? 2u : 0u) |
+                    (model_idx << 2));
+    if (sctrl._predicted.size() > 0) {
+      if (view_predict) {
+        get_points(canon_view_p[2], sctrl._predicted, sctrl.curr_idx);
+      } else {
+        get_points(predicted_p->predict[model_idx], sctrl._predicted,
+                   sctrl.curr_idx);
+      }
     }
 
     // get camera matrices & activate point shader
@@ -341,49 +1076,26 @@ void draw_frame() {
 
     point_sh.use();
 
-    // draw feature points
     glm::mat4 m_mat = glm::scale(glm::mat4(), glm::vec3(1.f, 1.f, 1.f));
-    point_sh.set_uniform((int)RE_Point::MV_m4x4, v_mat * m_mat);
-    point_sh.set_uniform((int)RE_Point::Proj_m4x4, p_mat);
-    point_sh.set_uniform((int)RE_Point::quad_h_width_f, sctrl.tile_size);
-    point_sh.set_uniform((int)RE_Point::color_v4, glm::vec4(1.f));
-
-    if (sctrl._input.size() > 0) {
-      ddGPUFrontEnd::draw_points(point_vao, point_ssbo,
-                                 ddAttribPrimitive::FLOAT, 0, 3, 3, 0, 0,
-                                 sctrl._input.size());
-    }
 
-    // ground truth
-    if (sctrl._ground.size() > 0) {
-      point_sh.set_uniform((int)RE_Point::color_v4,
-                           glm::vec4(0.f, 1.f, 0.f, 1.f));
-      get_points(groundtr_p, sctrl._ground, sctrl.curr_idx, VectorOut::OUTPUT);
-      ddGPUFrontEnd::set_storage_buffer_contents(
-          point_ssbo, sctrl._ground.sizeInBytes(), 0, &sctrl._ground[0]);
-      ddGPUFrontEnd::draw_points(point_vao, point_ssbo,
-                                 ddAttribPrimitive::FLOAT, 0, 3, 3, 0, 0,
-                                 sctrl._ground.size());
+    // trajectories underneath the points
+    if (show_trajectories) {
+      draw_trajectories(p_mat * v_mat * m_mat, sctrl.curr_idx);
+      point_sh.use();
     }
 
-    // predicted
-    if (sctrl._predicted.size() > 0) {
-      // update calculated points
-      if (tab_flag[0]) {  // normal
-        get_points(input_p[sctrl.curr_idx], weights, biases, sctrl._predicted);
-      } else {	// canonical
-        get_points(input_p[sctrl.curr_idx], weights_canon, biases_canon,
-                   sctrl._predicted);
-      }
+    // draw feature points
+    point_sh.set_uniform((int)RE_Point::MV_m4x4, v_mat * m_mat);
+    point_sh.set_uniform((int)RE_Point::Proj_m4x4, p_mat);
+    point_sh.set_uniform((int)RE_Point::quad_h_width_f, sctrl.tile_size);
 
-      point_sh.set_uniform((int)RE_Point::color_v4,
-                           glm::vec4(1.f, 0.f, 0.f, 1.f));
-      ddGPUFrontEnd::set_storage_buffer_contents(
-          point_ssbo, sctrl._predicted.sizeInBytes(), 0, &sctrl._predicted[0]);
-      ddGPUFrontEnd::draw_points(point_vao, point_ssbo,
-                                 ddAttribPrimitive::FLOAT, 0, 3, 3, 0, 0,
-                                 sctrl._predicted.size());
-    }
+    // input (white), ground truth (green) & predicted (red) in 1 call,
+    // moved toward the next frame by the playback time
+    const PlaySample &sample = playback.sample();
+    draw_sequence_points(sctrl.curr_idx, sample.frame == sctrl.curr_idx &&
+                                                 sample.next == sample.frame + 1
+                                             ? sample.blend
+                                             : 0.f);
 
     // render frame cutout (right side) ****************************************
     linedot_sh.use();
@@ -398,8 +1110,7 @@ void draw_frame() {
     linedot_sh.set_uniform((int)RE_LineDot::MVP_m4x4, identity);
     linedot_sh.set_uniform((int)RE_LineDot::send_to_back_b, true);
     linedot_sh.set_uniform((int)RE_LineDot::render_to_tex_b, false);
-    linedot_sh.set_uniform((int)RE_LineDot::color_v4,
-                           glm::vec4(0.5f, 0.5f, 0.5f, 1.f));
+    linedot_sh.set_uniform((int)RE_LineDot::color_v4, background_color);
     ddGPUFrontEnd::render_quad();
     linedot_sh.set_uniform((int)RE_LineDot::send_to_back_b, false);
 
@@ -423,6 +1134,187 @@ void draw_frame() {
   }
 }
 
+/** \brief Point source of 1 set (interleaved rows or PointSeq) */
+struct SetSource {
+  const RowMatrixXd *rows = nullptr;
+  const PointSeq *seq = nullptr;
+
+  unsigned frames() const {
+    return rows ? (unsigned)rows->rows() : (seq ? seq->frames : 0);
+  }
+  unsigned points() const {
+    return rows ? (unsigned)(rows->cols() / 2) : (seq ? seq->points : 0);
+  }
+};
+
+/** \brief Write set into its slot of every frame block */
+void pack_set(const SetSource &src, const uint32_t packed_color,
+              const float scale, const unsigned offset,
+              std::vector<glm::vec4> &out) {
+  const unsigned frames = src.frames();
+  const unsigned points = src.points();
+  const unsigned stride = gpu_seq.block_points;
+  const float color = (float)packed_color;
+
+  for (unsigned f = 0; f < gpu_seq.frames; f++) {
+    glm::vec4 *dst = out.data() + (size_t)f * stride + offset;
+    if (f >= frames) {
+      std::fill(dst, dst + points, glm::vec4(0.f));
+    } else if (src.rows) {
+      const double *row = src.rows->data() + (size_t)f * src.rows->cols();
+      for (unsigned p = 0; p < points; p++) {
+        dst[p] = glm::vec4((float)row[p * 2], (float)row[p * 2 + 1], color,
+                           scale);
+      }
+    } else {
+      for (unsigned p = 0; p < points; p++) {
+        dst[p] = glm::vec4(src.seq->x_track(p)[f], src.seq->y_track(p)[f],
+                           color, scale);
+      }
+    }
+  }
+}
+
+void upload_sequence(const unsigned layout) {
+  if (!gpu_seq.dirty && gpu_seq.layout == layout) return;
+  SVIS_SCOPE("upload_sequence");
+  gpu_seq.dirty = false;
+  gpu_seq.layout = layout;
+
+  std::vector<SetSource> sources(NUM_SETS);
+  std::vector<uint32_t> colors(set_colors, set_colors + NUM_SETS);
+  std::vector<float> scales(set_scales, set_scales + NUM_SETS);
+  if (layout & 1) {
+    sources[SET_INPUT].seq = &canon_view_p[0];
+    sources[SET_GROUND].seq = &canon_view_p[1];
+  } else {
+    sources[SET_INPUT].rows = &loaded_p->input.matrix();
+    sources[SET_GROUND].rows = &loaded_p->ground.matrix();
+  }
+  if (layout & 2) {
+    sources[SET_PREDICT].seq = &canon_view_p[2];
+  } else {
+    sources[SET_PREDICT].rows = &predicted_p->predict[(layout >> 2) & 1];
+  }
+  // visible comparison models follow in registry order (not in the
+  // canonical view, their output is in data space)
+  const size_t num_compare =
+      std::min(predicted_p->compare.size(), compare_models.size());
+  for (size_t c = 0; c < num_compare && !(layout & 1); c++) {
+    if (!compare_models[c]->visible) continue;
+    sources.push_back(SetSource());
+    sources.back().rows = &predicted_p->compare[c];
+    colors.push_back(compare_models[c]->color);
+    scales.push_back(set_scales[SET_PREDICT]);
+  }
+
+  // block covers the longest set
+  gpu_seq.frames = 0;
+  gpu_seq.block_points = 0;
+  for (size_t s = 0; s < sources.size(); s++) {
+    gpu_seq.frames = std::max(gpu_seq.frames, sources[s].frames());
+    gpu_seq.block_points += sources[s].points();
+  }
+
+  // + copy of the last block, so the next frame attribute of every frame
+  // is in the buffer
+  const size_t block = gpu_seq.block_points;
+  std::vector<glm::vec4> &staging = gpu_seq.staging;
+  staging.resize(gpu_seq.frames > 0 ? (gpu_seq.frames + 1) * block : 0);
+  if (staging.empty()) return;
+  unsigned offset = 0;
+  for (size_t s = 0; s < sources.size(); s++) {
+    pack_set(sources[s], colors[s], scales[s], offset, staging);
+    offset += sources[s].points();
+  }
+  std::copy(staging.end() - 2 * block, staging.end() - block,
+            staging.end() - block);
+
+  // grow buffer geometrically so stepping through files rarely reallocates
+  const size_t bytes = staging.size() * sizeof(glm::vec4);
+  if (bytes > gpu_seq.capacity) {
+    if (gpu_seq.ssbo) ddGPUFrontEnd::destroy_storage_buffer(gpu_seq.ssbo);
+    gpu_seq.capacity = std::max(bytes, gpu_seq.capacity * 2);
+    ddGPUFrontEnd::create_storage_buffer(gpu_seq.ssbo, gpu_seq.capacity);
+    ddGPUFrontEnd::bind_storage_buffer_atrribute(
+        point_vao, gpu_seq.ssbo, ddAttribPrimitive::FLOAT, 0, 4,
+        4 * sizeof(float), 0);
+    ddGPUFrontEnd::bind_storage_buffer_atrribute(
+        traj_vao, gpu_seq.ssbo, ddAttribPrimitive::FLOAT, 0, 4,
+        4 * sizeof(float), 0);
+  }
+  ddGPUFrontEnd::set_storage_buffer_contents(gpu_seq.ssbo, bytes, 0,
+                                             staging.data());
+  // same point 1 block later (playback interpolation)
+  ddGPUFrontEnd::bind_storage_buffer_atrribute(
+      point_vao, gpu_seq.ssbo, ddAttribPrimitive::FLOAT, 1, 4,
+      4 * sizeof(float), block * sizeof(glm::vec4));
+  SVIS_BYTES("upload_sequence", bytes);
+
+  // segment indices only depend on the block shape
+  if (gpu_seq.segment_frames == gpu_seq.frames &&
+      gpu_seq.segment_block == gpu_seq.block_points) {
+    return;
+  }
+  gpu_seq.segment_frames = gpu_seq.frames;
+  gpu_seq.segment_block = gpu_seq.block_points;
+
+  std::vector<unsigned> &segments = gpu_seq.segments;
+  segments.resize(gpu_seq.frames > 1 ? (size_t)(gpu_seq.frames - 1) * block * 2
+                                     : 0);
+  for (unsigned f = 0; f + 1 < gpu_seq.frames; f++) {
+    unsigned *dst = segments.data() + (size_t)f * block * 2;
+    for (unsigned k = 0; k < block; k++) {
+      dst[k * 2] = f * block + k;
+      dst[k * 2 + 1] = (f + 1) * block + k;
+    }
+  }
+  if (traj_ebo) ddGPUFrontEnd::destroy_index_buffer(traj_ebo);
+  if (segments.empty()) return;
+  ddGPUFrontEnd::create_index_buffer(
+      traj_ebo, segments.size() * sizeof(unsigned), segments.data());
+  SVIS_BYTES("upload_sequence", segments.size() * sizeof(unsigned));
+  ddGPUFrontEnd::bind_index_buffer(traj_vao, traj_ebo);
+}
+
+bool draw_sequence_points(const unsigned frame, const float blend) {
+  if (!gpu_seq.ssbo || frame >= gpu_seq.frames || gpu_seq.block_points == 0) {
+    return false;
+  }
+  point_sh.set_uniform((int)RE_Point::blend_f, blend);
+  ddGPUFrontEnd::draw_points(point_vao, gpu_seq.ssbo, ddAttribPrimitive::FLOAT,
+                             0, 4, 4, 0, frame * gpu_seq.block_points,
+                             gpu_seq.block_points);
+  return true;
+}
+
+void draw_trajectories(const glm::mat4 &mvp, const unsigned frame) {
+  if (!traj_ebo || frame >= gpu_seq.frames) return;
+
+  // segments ending at or before frame (or all of them)
+  const unsigned seg_size = gpu_seq.block_points * 2;
+  unsigned first = 0;
+  unsigned count = (gpu_seq.frames - 1) * seg_size;
+  if (trail_frames > 0) {
+    const unsigned start = frame > (unsigned)trail_frames
+                               ? frame - (unsigned)trail_frames
+                               : 0;
+    first = start * seg_size;
+    count = (frame - start) * seg_size;
+  }
+  if (count == 0) return;
+
+  traj_sh.use();
+  traj_sh.set_uniform((int)RE_Trajectory::MVP_m4x4, mvp);
+  traj_sh.set_uniform((int)RE_Trajectory::block_points_i,
+                      (int)gpu_seq.block_points);
+  traj_sh.set_uniform((int)RE_Trajectory::curr_frame_i, (int)frame);
+  traj_sh.set_uniform((int)RE_Trajectory::trail_frames_i, trail_frames);
+  traj_sh.set_uniform((int)RE_Trajectory::fade_color_v4,
+                      background_color);
+  ddGPUFrontEnd::draw_indexed_lines_vao(traj_vao, count, first);
+}
+
 void refill_buffer(const FrameData &data) {
   for (unsigned i = 0; i < MAX_POINTS; i++) {
     l_points[i] = data.verts[i];
@@ -444,6 +1336,539 @@ void refill_buffer(const FrameData &data) {
   texcoord_buff[5] = l_texcoords[3];
 }
 
+void predict_sequence(const FrameSeq &input, const ModelLayers &model,
+                      const InferenceMode mode, RowMatrixXd &out) {
+  SVIS_SCOPE("predict_sequence");
+  if (mode == InferenceMode::DOUBLE) {
+    std::vector<RowMatrixXd> batch_out;
+    feedForward_models(input, std::vector<const ModelLayers *>(1, &model),
+                       batch_out);
+    out.swap(batch_out[0]);
+    return;
+  }
+
+  // reduced backends pack their own converted copy, mapped layers are
+  // copied out for that
+  std::vector<Eigen::MatrixXd> w_copy;
+  std::vector<Eigen::VectorXd> b_copy;
+  if (model.mapped) model.copy_to(w_copy, b_copy);
+  ReducedMLP reduced;
+  if (input.empty() ||
+      !reduced.prepare(model.mapped ? w_copy : model.weights,
+                       model.mapped ? b_copy : model.biases, mode)) {
+    out.resize(0, 0);
+    return;
+  }
+  out.resize(input.size(), reduced.layers.back().out);
+  for (unsigned r = 0; r < input.size(); r++) {
+    reduced.eval(input.row_data(r), out.data() + r * out.cols());
+  }
+}
+
+ModelSet models_in_use() {
+  ModelSet m;
+  m.pair[0] = models[0];
+  m.pair[1] = models[1];
+  m.compare = compare_layers;
+  return m;
+}
+
+void predict_models(const ModelSet &m, const FrameSeq &input,
+                    const InferenceMode mode, RowMatrixXd *predict,
+                    std::vector<RowMatrixXd> &compare) {
+  SVIS_SCOPE("predict_models");
+  compare.resize(m.compare.size());
+  if (mode != InferenceMode::DOUBLE) {
+    // reduced backends evaluate frame by frame, 1 model at a time
+    for (unsigned i = 0; i < 2; i++) {
+      predict_sequence(input, *m.pair[i], mode, predict[i]);
+    }
+    for (size_t c = 0; c < m.compare.size(); c++) {
+      predict_sequence(input, *m.compare[c], mode, compare[c]);
+    }
+    return;
+  }
+
+  // shared input & fused 1st layer GEMM for every model
+  std::vector<const ModelLayers *> batch(2 + m.compare.size());
+  batch[0] = m.pair[0].get();
+  batch[1] = m.pair[1].get();
+  for (size_t c = 0; c < m.compare.size(); c++) {
+    batch[2 + c] = m.compare[c].get();
+  }
+  std::vector<RowMatrixXd> out;
+  feedForward_models(input, batch, out);
+  predict[0].swap(out[0]);
+  predict[1].swap(out[1]);
+  for (size_t c = 0; c < m.compare.size(); c++) compare[c].swap(out[2 + c]);
+}
+
+void compare_errors(const std::vector<RowMatrixXd> &compare,
+                    const FrameSeq &ground, std::vector<float> &out) {
+  out.assign(compare.size(), -1.f);
+  Eigen::MatrixXf errors;
+  for (size_t c = 0; c < compare.size(); c++) {
+    landmark_errors(compare[c], ground.matrix(), errors);
+    if (errors.size() > 0) out[c] = errors.mean();
+  }
+}
+
+glm::vec4 sequence_bounds(const FrameSeq &input, const FrameSeq &ground,
+                          const RowMatrixXd &predict) {
+  glm::vec4 bounds = empty_bounds();
+  grow_bounds(input.matrix(), 0, bounds);
+  grow_bounds(ground.matrix(), 0, bounds);
+  // skip leading non-landmark outputs
+  const unsigned skip = predict.cols() > ground.cols() && ground.cols() > 0
+                            ? (unsigned)predict.cols() - ground.cols()
+                            : 0;
+  grow_bounds(predict, skip, bounds);
+  return bounds;
+}
+
+void sequence_errors(const RowMatrixXd *predict, const FrameSeq &ground,
+                     Eigen::MatrixXf *errors, Eigen::VectorXf *frame_error) {
+  for (unsigned m = 0; m < 2; m++) {
+    landmark_errors(predict[m], ground.matrix(), errors[m]);
+    if (errors[m].cols() > 0) {
+      frame_error[m] = errors[m].rowwise().mean();
+    } else {
+      frame_error[m].resize(0);
+    }
+  }
+}
+
+/**
+ * \brief Run every model over input & derive errors/bounds into the
+ * prediction fields of data (input & ground may belong to another sequence)
+ */
+void predict_loaded(const ModelSet &m, const FrameSeq &input,
+                    const FrameSeq &ground, LoadedSequence &data) {
+  // run networks over whole sequence once
+  predict_models(m, input, (InferenceMode)data.infer_mode, data.predict,
+                 data.compare);
+  sequence_errors(data.predict, ground, data.errors, data.frame_error);
+  compare_errors(data.compare, ground, data.compare_error);
+  data.bounds =
+      sequence_bounds(input, ground, data.predict[data.canonical ? 1 : 0]);
+}
+
+/** \brief Parse file pair & predict w/ every model (reports stage if set) */
+std::unique_ptr<LoadedSequence> read_sequence(
+    const char *in_file, const char *g_file, const bool canonical,
+    const int mode, const ModelSet &m, std::atomic<unsigned> *stage = nullptr) {
+  SVIS_SCOPE("read_sequence");
+  std::unique_ptr<LoadedSequence> data(new LoadedSequence());
+  data->canonical = canonical;
+  data->infer_mode = mode;
+  // stamp before parsing, so a rewrite during the parse isn't cached as
+  // up to date
+  get_file_stamp(in_file, data->in_stamp);
+  get_file_stamp(g_file, data->g_stamp);
+
+  data->input = extract_vector2(
+      in_file, canonical ? VectorOut::INPUT_C : VectorOut::INPUT);
+  if (stage) *stage = 1;
+  data->ground = extract_vector2(
+      g_file, canonical ? VectorOut::OUTPUT_C : VectorOut::OUTPUT);
+  if (stage) *stage = 2;
+  predict_loaded(m, data->input, data->ground, *data);
+  if (stage) *stage = 3;
+  return data;
+}
+
+void start_sequence_load(const char *in_file, const char *g_file,
+                         const char *name, const bool canonical) {
+  // worker holds on to the current models so they can be swapped while it
+  // runs
+  const string512 in_name = in_file, g_name = g_file;
+  const int mode = infer_mode;
+  const unsigned generation = model_generation;
+  const ModelSet m = models_in_use();
+
+  loading_name = name;
+  load_stage = 0;
+  async_load = std::async(std::launch::async, [=]() {
+    // cache hit: displayed as is (entry stays shared & immutable)
+    std::shared_ptr<const LoadedSequence> cached =
+        seq_cache.find(in_name.str(), g_name.str(), mode);
+    if (cached && cached->canonical == canonical) {
+      load_stage = num_load_stages;
+      return cached;
+    }
+
+    std::unique_ptr<LoadedSequence> parsed = read_sequence(
+        in_name.str(), g_name.str(), canonical, mode, m, &load_stage);
+    parsed->generation = generation;
+    std::shared_ptr<const LoadedSequence> data(std::move(parsed));
+    if (generation == model_generation) seq_cache.insert(in_name.str(), data);
+    return data;
+  });
+}
+
+void start_prefetch(const bool canonical) {
+  // previous prefetch still running, next load retries
+  if (async_prefetch.valid() &&
+      async_prefetch.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+    return;
+  }
+
+  const dd_array<string512> &in_files = canonical ? files_canon : files;
+  const dd_array<const char *> &names =
+      canonical ? file_names_ptr_canon : file_names_ptr;
+  const int mode = infer_mode;
+
+  // only queue neighbours that aren't already resident
+  std::vector<string512> queue;
+  const int neighbours[2] = {selected_file + 1, selected_file - 1};
+  for (const int idx : neighbours) {
+    if (idx < 0 || idx >= (int)in_files.size()) continue;
+    const string512 g_file = gd_dir + "/" + names[idx];
+    if (seq_cache.contains(in_files[idx].str(), g_file.str(), mode)) continue;
+    queue.push_back(in_files[idx]);
+    queue.push_back(g_file);
+  }
+  if (queue.empty()) return;
+
+  const unsigned generation = model_generation;
+  const ModelSet m = models_in_use();
+  async_prefetch = std::async(std::launch::async, [=]() {
+    for (size_t i = 0; i + 1 < queue.size(); i += 2) {
+      std::unique_ptr<LoadedSequence> data = read_sequence(
+          queue[i].str(), queue[i + 1].str(), canonical, mode, m);
+      data->generation = generation;
+      if (generation != model_generation) return;
+      seq_cache.insert(queue[i].str(),
+                       std::shared_ptr<const LoadedSequence>(data.release()));
+    }
+  });
+}
+
+void poll_sequence_load() {
+  if (!async_load.valid() ||
+      async_load.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::ready) {
+    return;
+  }
+
+  // swap pointers (O(1)), previous sequence is freed unless still cached
+  const std::shared_ptr<const LoadedSequence> data = async_load.get();
+  loaded_p = data;
+  predicted_p = data;
+  loaded_canonical = data->canonical;
+  sctrl.bounds = data->bounds;
+  sequence_id++;
+
+  // canonical files have no header, names come from the normal files
+  landmark_labels =
+      landmark_names(VectorOut::OUTPUT, loaded_p->ground.cols() / 2);
+  error_items.assign(1, "mean of all landmarks");
+  for (size_t l = 0; l < landmark_labels.size(); l++) {
+    error_items.push_back(landmark_labels[l].str());
+  }
+  if (error_series >= (int)error_items.size()) error_series = 0;
+  gpu_seq.dirty = true;
+
+  // backend was changed or model swapped while loading (recomputed in the
+  // background, swapped in at a later frame)
+  if (data->infer_mode != infer_mode ||
+      data->generation != model_generation) {
+    start_repredict();
+  }
+
+  // set frame count (playback restarts w/ the new time index)
+  sctrl.num_frames = loaded_p->input.size();
+  build_playback_index();
+  if (sctrl.auto_fit) fit_ortho(sctrl);
+  // set array sizes
+  const VectorOut in_type =
+      loaded_canonical ? VectorOut::INPUT_C : VectorOut::INPUT;
+  const VectorOut g_type =
+      loaded_canonical ? VectorOut::OUTPUT_C : VectorOut::OUTPUT;
+  if (!loaded_p->input.empty()) {
+    get_points(loaded_p->input, sctrl._input, sctrl.curr_idx, in_type);
+  }
+  if (!loaded_p->ground.empty()) {
+    get_points(loaded_p->ground, sctrl._ground, sctrl.curr_idx, g_type);
+  }
+  const unsigned model_idx = loaded_canonical ? 1 : 0;
+  if (predicted_p->predict[model_idx].rows() > 0) {
+    get_points(predicted_p->predict[model_idx], sctrl._predicted,
+               sctrl.curr_idx);
+  }
+  refresh_canon_view();
+
+  // stepping through the list usually continues in the same direction
+  start_prefetch(loaded_canonical);
+}
+
+void build_playback_index() {
+  std::vector<double> times;
+  playback_timed = build_time_index(
+      loaded_p->input.matrix(),
+      loaded_canonical ? -1 : time_column(VectorOut::INPUT),
+      sctrl.frame_rate, times);
+  playback.set_index(times);
+  sctrl.curr_idx = playback.sample().frame;
+}
+
+void seek_frame(const unsigned frame) {
+  playback.seek_frame(frame);
+  sctrl.curr_idx = playback.sample().frame;
+}
+
+void update_playback() {
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  // long stalls (e.g. loading) don't skip ahead
+  const double dt = std::min(
+      std::chrono::duration<double>(now - playback_tick).count(), 0.25);
+  playback_tick = now;
+
+  playback.update(dt);
+  sctrl.curr_idx = playback.sample().frame;
+}
+
+void show_playback() {
+  if (playback.frames() == 0) return;
+
+  if (ImGui::Button(playback.playing ? "Pause" : "Play")) {
+    playback.playing = !playback.playing;
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("<")) playback.step(-1);
+  ImGui::SameLine();
+  if (ImGui::Button(">")) playback.step(1);
+  ImGui::SameLine();
+  ImGui::Text("%.2f / %.2f s, frame %u/%u (%s)", playback.time(),
+              playback.duration(), playback.sample().frame + 1,
+              playback.frames(), playback_timed ? "capture time" : "fixed rate");
+
+  int mode = (int)playback.mode;
+  if (ImGui::Combo("Playback", &mode, play_mode_names,
+                   (int)PlayMode::COUNT)) {
+    playback.mode = (PlayMode)mode;
+  }
+  if (playback.mode == PlayMode::SCALED) {
+    ImGui::SliderFloat("Speed", &playback.speed, 0.05f, 4.f, "%.2fx");
+  }
+  sctrl.curr_idx = playback.sample().frame;
+}
+
+void show_load_progress() {
+  static const char *stage_names[num_load_stages + 1] = {
+      "input", "ground truth", "predictions", "done"};
+  const unsigned stage = load_stage;
+  string64 overlay;
+  overlay.format("%s: %s", loading_name.str(), stage_names[stage]);
+  ImGui::ProgressBar((float)stage / num_load_stages, ImVec2(-1, 0),
+                     overlay.str());
+}
+
+void show_compare_models() {
+  if (compare_models.empty()) return;
+  ImGui::Text("Comparison models (mean error)");
+  for (size_t c = 0; c < compare_models.size(); c++) {
+    CompareModel &model = *compare_models[c];
+    const uint32_t col = model.color;
+    ImGui::TextColored(ImVec4((col & 0xFF) / 255.f, ((col >> 8) & 0xFF) / 255.f,
+                              ((col >> 16) & 0xFF) / 255.f, 1.f),
+                       "o");
+    ImGui::SameLine();
+    if (ImGui::Checkbox(model.name.str(), &model.visible)) {
+      gpu_seq.dirty = true;
+    }
+    ImGui::SameLine();
+    const std::vector<float> &errors = predicted_p->compare_error;
+    if (c < errors.size() && errors[c] >= 0.f) {
+      ImGui::Text("%.4f", errors[c]);
+    } else {
+      ImGui::Text("-");
+    }
+  }
+}
+
+void show_cache_stats() {
+  if (ImGui::SliderInt("Cache budget (MB)", &cache_budget_mb, 16, 4096)) {
+    seq_cache.set_budget((size_t)cache_budget_mb << 20);
+  }
+  const SequenceLRU::Stats stats = seq_cache.stats();
+  ImGui::Text("Cache: %u sequences, %.1f / %.0f MB", stats.entries,
+              stats.resident_bytes / (1024.0 * 1024.0),
+              stats.budget_bytes / (1024.0 * 1024.0));
+  ImGui::Text("       hits %lu, misses %lu, evictions %lu", stats.hits,
+              stats.misses, stats.evictions);
+}
+
+void show_error_timeline() {
+  // same model as the drawn predictions
+  const unsigned m = tab_flag[0] ? 0 : 1;
+  const Eigen::MatrixXf &errors = predicted_p->errors[m];
+  if (errors.size() == 0) return;
+  const unsigned frames = (unsigned)errors.rows();
+  const unsigned curr = std::min(sctrl.curr_idx, frames - 1);
+
+  ImGui::Combo("Error of", &error_series, error_items.data(),
+               (int)error_items.size());
+  const float *values = error_series > 0
+                            ? errors.col(error_series - 1).data()
+                            : predicted_p->frame_error[m].data();
+
+  string64 overlay;
+  overlay.format("frame %u: %.2f", curr, values[curr]);
+  if (error_bars) {
+    ImGui::PlotHistogram("##error", values, (int)frames, 0, overlay.str(),
+                         0.f, FLT_MAX, ImVec2(-1, 80));
+  } else {
+    ImGui::PlotLines("##error", values, (int)frames, 0, overlay.str(), 0.f,
+                     FLT_MAX, ImVec2(-1, 80));
+  }
+  // click/drag on the plot to seek
+  if (ImGui::IsItemHovered() && ImGui::IsMouseDown(0)) {
+    const float x = ImGui::GetMousePos().x - ImGui::GetItemRectMin().x;
+    const float t = x / std::max(ImGui::GetItemRectSize().x, 1.f);
+    seek_frame((unsigned)std::max(
+        0, std::min((int)(t * frames), (int)frames - 1)));
+  }
+  if (ImGui::Button("Worst frame")) {
+    Eigen::Index worst = 0;
+    Eigen::Map<const Eigen::VectorXf>(values, frames).maxCoeff(&worst);
+    seek_frame((unsigned)worst);
+  }
+  ImGui::SameLine();
+  ImGui::Checkbox("Bars", &error_bars);
+
+  // current frame (predictions line up w/ ground truth from the back)
+  if (sctrl._ground.size() == 0) return;
+  const unsigned skip = sctrl._predicted.size() > sctrl._ground.size()
+                            ? sctrl._predicted.size() - sctrl._ground.size()
+                            : 0;
+  const unsigned landmarks =
+      std::min((unsigned)errors.cols(), (unsigned)sctrl._ground.size());
+  for (unsigned l = 0; l < landmarks && l + skip < sctrl._predicted.size();
+       l++) {
+    const glm::vec3 &g = sctrl._ground[l];
+    const glm::vec3 &p = sctrl._predicted[l + skip];
+    ImGui::Text("%-24s g (%7.1f, %7.1f) p (%7.1f, %7.1f) %6.2f px",
+                landmark_labels[l].str(), g.x, g.y, p.x, p.y,
+                errors(curr, l));
+  }
+}
+
+void show_stats() {
+  ImGui::SetNextWindowSize(ImVec2(560, 0));
+  ImGui::Begin("Stats", &show_stats_overlay, ImGuiWindowFlags_NoSavedSettings);
+
+  bool enabled = stats_enabled();
+  if (ImGui::Checkbox("Collect", &enabled)) set_stats_enabled(enabled);
+  ImGui::SameLine();
+  if (ImGui::Button("Reset")) stats_reset();
+  ImGui::SameLine();
+  if (!trace_recording()) {
+    if (ImGui::Button("Record trace")) trace_start();
+  } else if (ImGui::Button("Save trace")) {
+    trace_stop();
+    if (trace_save(trace_file.str())) {
+      ddTerminal::f_post("Saved trace: %s", trace_file.str());
+    } else {
+      ddTerminal::f_post("[error]Can't write trace: %s", trace_file.str());
+    }
+  }
+  if (trace_recording()) {
+    ImGui::SameLine();
+    ImGui::Text("%lu events", (unsigned long)trace_events());
+  }
+
+  const std::vector<StatSnapshot> snap = stats_snapshot();
+  ImGui::Columns(6, "stats");
+  const char *headers[6] = {"site", "calls", "avg ms", "max ms", "total ms",
+                            "MB"};
+  for (unsigned c = 0; c < 6; c++) {
+    ImGui::Text("%s", headers[c]);
+    ImGui::NextColumn();
+  }
+  ImGui::Separator();
+  for (size_t i = 0; i < snap.size(); i++) {
+    ImGui::Text("%s", snap[i].name.str());
+    ImGui::NextColumn();
+    ImGui::Text("%lu", (unsigned long)snap[i].calls);
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", snap[i].avg_ms);
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", snap[i].max_ms);
+    ImGui::NextColumn();
+    ImGui::Text("%.1f", snap[i].total_ms);
+    ImGui::NextColumn();
+    ImGui::Text("%.2f", snap[i].bytes / (1024.0 * 1024.0));
+    ImGui::NextColumn();
+  }
+  ImGui::Columns(1);
+
+  ImGui::End();
+}
+
+void refresh_canon_view() {
+  gpu_seq.dirty = true;
+  for (unsigned i = 0; i < 3; i++) canon_view_p[i] = PointSeq();
+  // only raw data from the normal tab needs transforming
+  if (!canon_view || loaded_p->input.empty() || loaded_canonical) return;
+
+  to_point_seq(loaded_p->input.matrix(), canon_view_p[0]);
+  to_point_seq(loaded_p->ground.matrix(), canon_view_p[1]);
+  to_point_seq(predicted_p->predict[0], canon_view_p[2]);
+
+  // predictions share the frame transforms derived from the ground truth
+  CanonTransforms xforms;
+  if (!canonicalize_sequence(canon_view_p[0], canon_view_p[1],
+                             glm::vec2(-0.5f, 0.f), 1.f, xforms)) {
+    ddTerminal::post("[error]Canonical view: sequence has no reference points");
+    for (unsigned i = 0; i < 3; i++) canon_view_p[i] = PointSeq();
+    return;
+  }
+  if (canon_view_p[2].frames == canon_view_p[0].frames) {
+    apply_transforms(xforms, canon_view_p[2]);
+  } else {
+    canon_view_p[2] = PointSeq();
+  }
+}
+
+void show_export_progress() {
+  if (!export_progress) return;
+  const ExportProgress &prog = *export_progress;
+
+  // collect finished export (also when it failed before starting)
+  if (async_canonical.valid() && prog.finished) async_canonical.get();
+  if (prog.failed) {
+    ImGui::Text("Export failed: input or ground truth folder not found");
+    return;
+  }
+  if (!prog.started) return;
+
+  const unsigned total = (unsigned)prog.files.size();
+  string64 overlay;
+  overlay.format("%u/%u files", prog.files_done.load(), total);
+  ImGui::ProgressBar(total > 0 ? (float)prog.files_done / total : 1.f,
+                     ImVec2(-1, 0), overlay.str());
+
+  if (!prog.finished) {
+    // files currently being worked on
+    for (unsigned f = 0; f < total; f++) {
+      const unsigned frames = prog.files[f].frames;
+      const unsigned done = prog.files[f].frames_done;
+      if (frames > 0 && done < frames) {
+        ImGui::Text("  %s: %u/%u frames", prog.files[f].name.str(), done,
+                    frames);
+      }
+    }
+  } else {
+    ImGui::Text("%s: %lu frames in %.2f s on %u threads (%.0f frames/s)",
+                prog.cancel ? "Cancelled" : "Exported", prog.frames_done.load(),
+                prog.seconds, prog.threads,
+                prog.frames_done / std::max(prog.seconds, 1e-9));
+  }
+}
+
 void set_imgui_style() {
   ImGuiStyle *style = &ImGui::GetStyle();
 
@@ -512,6 +1937,7 @@ void set_imgui_style() {
 }
 
 int load_ui(lua_State *L) {
+  SVIS_SCOPE("load_ui");
   bool win_on = true;
 
   // window position and size
@@ -528,6 +1954,11 @@ int load_ui(lua_State *L) {
 
   ImGui::Begin("Smile Visualization", &win_on, window_flags);
 
+  // frame boundary: swap in sequence finished loading since last frame
+  poll_sequence_load();
+  poll_model_reload();
+  update_playback();
+
   // stop edge clipping
   ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.7f);
 
@@ -556,58 +1987,50 @@ int load_ui(lua_State *L) {
                          (int)file_names_ptr.size(), 10);
 
           // button to load data
-          if (ImGui::Button("Load selected")) {
-            // load input
-            input_p =
-                extract_vector2(files[selected_file].str(), VectorOut::INPUT);
-            // load ground truth
+          if (async_load.valid()) {
+            show_load_progress();
+          } else if (ImGui::Button("Load selected")) {
+            // load input & ground truth in the background
 						string512 ground_file = gd_dir + "/" + file_names_ptr[selected_file];
-            groundtr_p = extract_vector2(ground_file.str(), VectorOut::OUTPUT);
-
-            // set frame count
-            sctrl.curr_idx = 0;
-            sctrl.num_frames = input_p.size();
-            // set array sizes
-            get_points(input_p, sctrl._input, sctrl.curr_idx, VectorOut::INPUT);
-            get_points(groundtr_p, sctrl._ground, sctrl.curr_idx,
-                       VectorOut::OUTPUT);
-            get_points(input_p[sctrl.curr_idx], weights, biases,
-                       sctrl._predicted);
+            start_sequence_load(files[selected_file].str(), ground_file.str(),
+                                file_names_ptr[selected_file], false);
           }
 
           // button to create & export data in canonical space
           ImGui::SameLine();
-          if (ImGui::Button("Export canonical")) {
-            const glm::vec2 canon_point(-0.5f, 0.f);
-            const float canon_space = 1.0f;
-            async_canonical =
-                std::async(std::launch::async, export_canonical, f_dir.str(),
-                           gd_dir.str(), canon_point, canon_space);
+          if (!async_canonical.valid()) {
+            if (ImGui::Button("Export canonical")) {
+              const glm::vec2 canon_point(-0.5f, 0.f);
+              const float canon_space = 1.0f;
+              export_progress.reset(new ExportProgress());
+              async_canonical = std::async(
+                  std::launch::async, export_canonical, f_dir.str(),
+                  gd_dir.str(), canon_point, canon_space,
+                  (unsigned)export_threads, export_progress.get());
+            }
+          } else if (ImGui::Button("Cancel export")) {
+            export_progress->cancel = true;
+          }
+          if (ImGui::Checkbox("Canonical view", &canon_view)) {
+            refresh_canon_view();
           }
+          ImGui::SliderInt("Export threads", &export_threads, 1,
+                           std::max(1, (int)std::thread::hardware_concurrency()));
+          show_export_progress();
           break;
         case 1:  // canonical
           ImGui::ListBox("<-- Select data", &selected_file,
                          &file_names_ptr_canon[0],
                          (int)file_names_ptr_canon.size(), 10);
           // button to load data
-          if (ImGui::Button("Load selected")) {
-            // load input
-            input_p = extract_vector2(files_canon[selected_file].str(),
-                                      VectorOut::INPUT_C);
-            // load ground truth
+          if (async_load.valid()) {
+            show_load_progress();
+          } else if (ImGui::Button("Load selected")) {
+            // load input & ground truth in the background
 						string512 ground_file = gd_dir + "/" + file_names_ptr_canon[selected_file];
-            groundtr_p = extract_vector2(ground_file.str(), VectorOut::OUTPUT_C);
-
-            // set frame count
-            sctrl.curr_idx = 0;
-            sctrl.num_frames = input_p.size();
-            // set array sizes
-            get_points(input_p, sctrl._input, sctrl.curr_idx,
-                       VectorOut::INPUT_C);
-            get_points(groundtr_p, sctrl._ground, sctrl.curr_idx,
-                       VectorOut::OUTPUT_C);
-            get_points(input_p[sctrl.curr_idx], weights_canon, biases_canon,
-                       sctrl._predicted);
+            start_sequence_load(files_canon[selected_file].str(),
+                                ground_file.str(),
+                                file_names_ptr_canon[selected_file], true);
           }
           break;
         default:
@@ -621,94 +2044,55 @@ int load_ui(lua_State *L) {
     ImGui::Text("No Folders loaded/Folder not found");
     ImGui::PopStyleColor();
   }
+  show_playback();
+  ImGui::Checkbox("Trajectories", &show_trajectories);
+  if (show_trajectories) {
+    ImGui::SliderInt("Trail frames (0: all)", &trail_frames, 0, 600);
+  }
+  show_compare_models();
+  show_cache_stats();
+  ImGui::Checkbox("Stats overlay", &show_stats_overlay);
   ImGui::Separator();
 
-  if (sctrl._predicted.size() > 0) {
-    // if (false) {
-    // difference
-    unsigned idx = 0;
-    // Lateral canthus
-    ImGui::Text("Lateral canthus (L)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Lateral canthus (R)
-    ImGui::Text("Lateral canthus (R)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Palpebral fissure (RU)
-    ImGui::Text("Palpebral fissure (RU)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Palpebral fissure (RL)
-    ImGui::Text("Palpebral fissure (RL)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Palpebral fissure (LU)
-    ImGui::Text("Palpebral fissure (LU)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Palpebral fissure (LL)
-    ImGui::Text("Palpebral fissure (LL)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Depressor (L)
-    ImGui::Text("Depressor (L)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Depressor (R)
-    ImGui::Text("Depressor (R)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Depressor (M)
-    ImGui::Text("Depressor (M)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Iris (M)
-    // Iris (L)
-    // Nasal ala (L)
-    ImGui::Text("Nasal ala (L)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Nasal ala (R)
-    ImGui::Text("Nasal ala (R)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Medial brow (L)
-    ImGui::Text("Medial brow (L)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Medial brow (R)
-    ImGui::Text("Medial brow (R)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Malar eminence (L)
-    ImGui::Text("Malar eminence (L)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
-    // Malar eminence (R)
-    ImGui::Text("Malar eminence (R)");
-    ImGui::InputFloat2("ground", &sctrl._ground[idx][0]);
-    ImGui::InputFloat2("predict", &sctrl._predicted[idx][0]);
-    idx++;
+  // inference backend
+  if (ImGui::Combo("Inference", &infer_mode, inference_mode_names,
+                   (int)InferenceMode::COUNT)) {
+    // current predictions stay up until the new backend's are swapped in
+    start_repredict();
   }
+  if (!async_accuracy.valid()) {
+    if (ImGui::Button("Accuracy report")) {
+      string512 data_dir;
+      data_dir.format("%s/smile_vis/all_data", PROJECT_DIR);
+      const std::shared_ptr<const ModelLayers> model = models[0];
+      async_accuracy = std::async(std::launch::async, [data_dir, model]() {
+        std::vector<Eigen::MatrixXd> w;
+        std::vector<Eigen::VectorXd> b;
+        model->copy_to(w, b);
+        return report_inference_accuracy(data_dir.str(), w, b);
+      });
+    }
+  } else if (async_accuracy.wait_for(std::chrono::seconds(0)) ==
+             std::future_status::ready) {
+    accuracy_stats = async_accuracy.get();
+  } else {
+    ImGui::Text("Running accuracy report...");
+  }
+  for (size_t i = 0; i < accuracy_stats.size(); i++) {
+    const AccuracyStats &st = accuracy_stats[i];
+    ImGui::Text("%-8s max %.4f px, mean %.4f px, %.0f ns/frame",
+                inference_mode_names[(unsigned)st.mode], st.max_dev,
+                st.mean_dev, st.ns_per_frame);
+  }
+  ImGui::Separator();
+
+  show_error_timeline();
 
   ImGui::PopItemWidth();
   ImGui::End();
 
+  if (show_stats_overlay) show_stats();
+
   return 0;
 }
 
@@ -717,6 +2101,11 @@ void load_files(const char *directory, const bool ground_truth) {
     // log ground truth directory
     gd_dir = directory;
   } else {
+    // binary caches of parsed sequences
+    string512 cache_dir;
+    cache_dir.format("%s/smile_vis/.svcache", PROJECT_DIR);
+    set_seq_cache_dir(cache_dir.str());
+
     // open folder & extract files
     f_dir = directory;
     ddIO folder_handle;
@@ -769,38 +2158,148 @@ void load_files(const char *directory, const bool ground_truth) {
   }
 }
 
-void load_weights(const char *directory) {
-  // open folder & extract files
-  ddIO folder_handle;
-  folder_handle.open(directory, ddIOflag::DIRECTORY);
-  dd_array<string512> unfiltered = folder_handle.get_directory_files();
+/** \brief Drop cached predictions made w/ the previous model */
+void invalidate_sequence_cache() {
+  seq_cache.clear(++model_generation);
+}
 
-  // check if file contains .csv
-  DD_FOREACH(string512, file, unfiltered) {
-    // load up matching files
-    if (file.ptr->contains(".csv") && file.ptr->contains("canon")) {
-      // canonical
-      weights_canon.push_back(extract_matrix(file.ptr->str()));
-    } else if (file.ptr->contains(".csv")) {
-      weights.push_back(extract_matrix(file.ptr->str()));
-    }
+void load_model(const unsigned idx, const char *weight_dir,
+                const char *bias_dir) {
+  SVIS_SCOPE("load_model");
+  // folders can't change under a running reload
+  if (async_reload.valid()) async_reload.get();
+
+  model_src[idx & 1].set_folders(weight_dir, bias_dir);
+  model_src[idx & 1].reload();
+  watch_model_folders();
+  swap_models();
+}
+
+void watch_model_folders() {
+  model_watch.clear();
+  for (unsigned m = 0; m < 2; m++) {
+    if (model_src[m].weight_folder().empty()) continue;
+    model_watch.add(model_src[m].weight_folder().c_str());
+    model_watch.add(model_src[m].bias_folder().c_str());
+  }
+  for (const std::unique_ptr<CompareModel> &c : compare_models) {
+    model_watch.add(c->source.weight_folder().c_str());
+    model_watch.add(c->source.bias_folder().c_str());
+  }
+}
+
+bool add_compare_model(const char *name, const char *weight_dir,
+                       const char *bias_dir, const uint32_t color) {
+  SVIS_SCOPE("load_model");
+  // registry can't change under a running reload
+  if (async_reload.valid()) async_reload.get();
+
+  std::unique_ptr<CompareModel> model(new CompareModel());
+  model->name = name;
+  model->color = color;
+  model->source.set_folders(weight_dir, bias_dir);
+  model->source.reload();
+  if (model->source.model()->num_layers() == 0) return false;
+
+  // same name replaces (e.g. a newer checkpoint)
+  bool replaced = false;
+  for (std::unique_ptr<CompareModel> &c : compare_models) {
+    if (std::strcmp(c->name.str(), name) != 0) continue;
+    c.swap(model);
+    replaced = true;
   }
+  if (!replaced) compare_models.push_back(std::move(model));
+  watch_model_folders();
+  swap_models();
+  return true;
 }
 
-void load_biases(const char *directory) {
-  // open folder & extract files
-  ddIO folder_handle;
-  folder_handle.open(directory, ddIOflag::DIRECTORY);
-  dd_array<string512> unfiltered = folder_handle.get_directory_files();
+bool remove_compare_model(const char *name) {
+  if (async_reload.valid()) async_reload.get();
+
+  for (size_t c = 0; c < compare_models.size(); c++) {
+    if (std::strcmp(compare_models[c]->name.str(), name) != 0) continue;
+    compare_models.erase(compare_models.begin() + c);
+    watch_model_folders();
+    swap_models();
+    return true;
+  }
+  return false;
+}
+
+void poll_model_reload() {
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (model_watch.poll()) {
+    model_changed = true;
+    model_change_time = now;
+  }
 
-  // check if file contains .csv
-  DD_FOREACH(string512, file, unfiltered) {
-    // load up matching files
-    if (file.ptr->contains(".csv") && file.ptr->contains("canon")) {
-      // canonical
-      biases_canon.push_back(extract_vector(file.ptr->str()));
-    } else if (file.ptr->contains(".csv")) {
-      biases.push_back(extract_vector(file.ptr->str()));
+  // frame boundary: swap in reloaded models
+  if (async_reload.valid() && async_reload.wait_for(std::chrono::seconds(
+                                  0)) == std::future_status::ready) {
+    if (async_reload.get()) swap_models();
+  }
+  if (model_changed && !async_reload.valid() &&
+      now - model_change_time >= model_settle) {
+    model_changed = false;
+    async_reload = std::async(std::launch::async, []() {
+      SVIS_SCOPE("model_reload");
+      bool changed = false;
+      for (unsigned m = 0; m < 2; m++) changed |= model_src[m].reload();
+      for (const std::unique_ptr<CompareModel> &c : compare_models) {
+        changed |= c->source.reload();
+      }
+      return changed;
+    });
+  }
+
+  // frame boundary: swap in recomputed predictions
+  if (async_predict.valid() && async_predict.wait_for(std::chrono::seconds(
+                                   0)) == std::future_status::ready) {
+    std::unique_ptr<LoadedSequence> data = async_predict.get();
+    // dropped if another sequence or backend was selected meanwhile
+    if (repredict_id == sequence_id && data->infer_mode == infer_mode) {
+      sctrl.bounds = data->bounds;
+      predicted_p = std::move(data);
+      if (sctrl.auto_fit) fit_ortho(sctrl);
+      gpu_seq.dirty = true;
+      refresh_canon_view();
     }
   }
+  if (repredict_pending && !async_predict.valid()) start_repredict();
+}
+
+void swap_models() {
+  for (unsigned m = 0; m < 2; m++) models[m] = model_src[m].model();
+  compare_layers.resize(compare_models.size());
+  for (size_t c = 0; c < compare_models.size(); c++) {
+    compare_layers[c] = compare_models[c]->source.model();
+  }
+  invalidate_sequence_cache();
+  start_repredict();
+}
+
+void start_repredict() {
+  if (loaded_p->input.empty()) return;
+  // 1 at a time (reassigning a running std::async future would block)
+  if (async_predict.valid()) {
+    repredict_pending = true;
+    return;
+  }
+  repredict_pending = false;
+
+  // worker shares the (immutable) loaded sequence & only fills in the
+  // prediction outputs, swapped in by poll_model_reload
+  std::shared_ptr<LoadedSequence> job = std::make_shared<LoadedSequence>();
+  job->canonical = loaded_canonical;
+  job->infer_mode = infer_mode;
+  job->generation = model_generation;
+  repredict_id = sequence_id;
+  const std::shared_ptr<const LoadedSequence> seq = loaded_p;
+  const ModelSet m = models_in_use();
+  async_predict = std::async(std::launch::async, [job, seq, m]() {
+    predict_loaded(m, seq->input, seq->ground, *job);
+    return std::unique_ptr<LoadedSequence>(new LoadedSequence(std::move(*job)));
+  });
 }
@@ -22,11 +22,26 @@ int load_ui(lua_State *L);
 /** \brief Sets the list of files visible in menu */
 void load_files(const char *directory, const bool ground_truth = false);
 
-/** \brief Sets weights */
-void load_weights(const char *directory);
-
-/** \brief Sets biases */
-void load_biases(const char *directory);
+/**
+ * \brief Sets model from weight & bias folders (0: normal, 1: canonical)
+ *
+ * The folders are watched afterwards & changed layers are reloaded between
+ * frames.
+ */
+void load_model(const unsigned idx, const char *weight_dir,
+                const char *bias_dir);
+
+/**
+ * \brief Add named model evaluated & overlaid next to the selected one
+ * (replaces one w/ the same name, folders are watched like load_model)
+ * \param color Packed r | g << 8 | b << 16
+ * \return false if no model could be loaded from the folders
+ */
+bool add_compare_model(const char *name, const char *weight_dir,
+                       const char *bias_dir, const uint32_t color);
+
+/** \brief Drop comparison model (false if there is none w/ that name) */
+bool remove_compare_model(const char *name);
 
 /** \brief Log lua library for controlling data & frames */
 void register_lua_controller(lua_State *L);
\ No newline at end of file
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "Eigen/Core"
+#include <vector>
+
+/**
+ * Allocation-free evaluator for the landmark MLP.
+ *
+ * MLPEvaluator<12, 200, 100, 34> bakes the layer sizes into the type so every
+ * GEMV and bias/RELU pass is emitted with compile-time dimensions.
+ * MLPEvaluator<> is the runtime-sized fallback for any other architecture.
+ * Both keep weights pre-transposed (out x in, row-major) in one aligned block
+ * and ping-pong between 2 preallocated work vectors, so eval() never touches
+ * the heap.
+ */
+
+namespace mlp_detail {
+/** \brief Pad parameter counts so every layer starts on a 64 byte boundary */
+constexpr int padded(const int n) { return (n + 7) & ~7; }
+
+constexpr int max_dim(const int a) { return a; }
+template <typename... R>
+constexpr int max_dim(const int a, const int b, R... rest) {
+  return max_dim(a > b ? a : b, rest...);
+}
+
+template <typename... R>
+constexpr int first_dim(const int a, R...) {
+  return a;
+}
+
+constexpr int last_dim(const int a) { return a; }
+template <typename... R>
+constexpr int last_dim(const int, const int b, R... rest) {
+  return last_dim(b, rest...);
+}
+
+typedef std::vector<double, Eigen::aligned_allocator<double>> ParamBlock;
+
+/** \brief Recursive chain of fixed size layers (RELU on all but last) */
+template <int In, int Out, int... Rest>
+struct MLPChain {
+  typedef MLPChain<Out, Rest...> Next;
+  static constexpr int layer_params = padded(Out * In + Out);
+  static constexpr int params = layer_params + Next::params;
+
+  /** \brief Copy (in x out) weights into pre-transposed aligned storage */
+  static bool pack(const std::vector<Eigen::MatrixXd> &weights,
+                   const std::vector<Eigen::VectorXd> &biases,
+                   const unsigned layer, double *p) {
+    if (weights[layer].rows() != In || weights[layer].cols() != Out ||
+        biases[layer].size() != Out) {
+      return false;
+    }
+    Eigen::Map<Eigen::Matrix<double, Out, In, Eigen::RowMajor>,
+               Eigen::Aligned16>
+        wt(p);
+    Eigen::Map<Eigen::Matrix<double, Out, 1>> b(p + Out * In);
+    wt = weights[layer].transpose();
+    b = biases[layer];
+    return Next::pack(weights, biases, layer + 1, p + layer_params);
+  }
+
+  static void eval(const double *p, const double *src, double *dst,
+                   double *spare, double *out) {
+    const Eigen::Map<const Eigen::Matrix<double, Out, In, Eigen::RowMajor>,
+                     Eigen::Aligned16>
+        wt(p);
+    const Eigen::Map<const Eigen::Matrix<double, Out, 1>> b(p + Out * In);
+    Eigen::Map<Eigen::Matrix<double, Out, 1>, Eigen::Aligned16> layer(dst);
+
+    layer.noalias() = wt * Eigen::Map<const Eigen::Matrix<double, In, 1>>(src);
+    layer = (layer + b).cwiseMax(0.0);
+
+    // output of this layer becomes input of the next (ping-pong)
+    Next::eval(p + layer_params, dst, spare, dst, out);
+  }
+};
+
+template <int In, int Out>
+struct MLPChain<In, Out> {
+  static constexpr int layer_params = padded(Out * In + Out);
+  static constexpr int params = layer_params;
+
+  static bool pack(const std::vector<Eigen::MatrixXd> &weights,
+                   const std::vector<Eigen::VectorXd> &biases,
+                   const unsigned layer, double *p) {
+    if (weights.size() != layer + 1 || weights[layer].rows() != In ||
+        weights[layer].cols() != Out || biases[layer].size() != Out) {
+      return false;
+    }
+    Eigen::Map<Eigen::Matrix<double, Out, In, Eigen::RowMajor>,
+               Eigen::Aligned16>
+        wt(p);
+    Eigen::Map<Eigen::Matrix<double, Out, 1>> b(p + Out * In);
+    wt = weights[layer].transpose();
+    b = biases[layer];
+    return true;
+  }
+
+  static void eval(const double *p, const double *src, double *, double *,
+                   double *out) {
+    const Eigen::Map<const Eigen::Matrix<double, Out, In, Eigen::RowMajor>,
+                     Eigen::Aligned16>
+        wt(p);
+    const Eigen::Map<const Eigen::Matrix<double, Out, 1>> b(p + Out * In);
+    Eigen::Map<Eigen::Matrix<double, Out, 1>> layer(out);
+
+    layer.noalias() = wt * Eigen::Map<const Eigen::Matrix<double, In, 1>>(src);
+    layer += b;
+  }
+};
+}  // namespace mlp_detail
+
+/** \brief Fixed size evaluator (Dims = input, hidden..., output) */
+template <int... Dims>
+class MLPEvaluator {
+  static_assert(sizeof...(Dims) >= 2, "MLP needs at least one layer");
+  typedef mlp_detail::MLPChain<Dims...> Chain;
+
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  static constexpr int in_size = mlp_detail::first_dim(Dims...);
+  static constexpr int out_size = mlp_detail::last_dim(Dims...);
+
+  /** \brief Pack weights & biases (returns false on shape mismatch) */
+  bool load(const std::vector<Eigen::MatrixXd> &weights,
+            const std::vector<Eigen::VectorXd> &biases) {
+    params.assign(Chain::params, 0.0);
+    ready = weights.size() == biases.size() &&
+            Chain::pack(weights, biases, 0, params.data());
+    return ready;
+  }
+
+  bool loaded() const { return ready; }
+  unsigned input_size() const { return in_size; }
+  unsigned output_size() const { return out_size; }
+
+  /** \brief Evaluate one sample. No heap allocations */
+  void eval(const double *input, double *output) {
+    Chain::eval(params.data(), input, work[0].data(), work[1].data(), output);
+  }
+
+ private:
+  mlp_detail::ParamBlock params;
+  Eigen::Matrix<double, mlp_detail::max_dim(Dims...), 1> work[2];
+  bool ready = false;
+};
+
+/** \brief Runtime sized fallback */
+template <>
+class MLPEvaluator<> {
+ public:
+  /** \brief Pack weights & biases (returns false on shape mismatch) */
+  bool load(const std::vector<Eigen::MatrixXd> &weights,
+            const std::vector<Eigen::VectorXd> &biases) {
+    ready = false;
+    if (weights.empty() || weights.size() != biases.size()) return false;
+
+    dims.assign(1, (int)weights[0].rows());
+    int total = 0, widest = weights[0].rows();
+    for (size_t i = 0; i < weights.size(); i++) {
+      if (weights[i].rows() != dims.back() ||
+          biases[i].size() != weights[i].cols()) {
+        return false;
+      }
+      dims.push_back(weights[i].cols());
+      total += mlp_detail::padded(weights[i].size() + biases[i].size());
+      widest = std::max(widest, (int)weights[i].cols());
+    }
+
+    params.assign(total, 0.0);
+    double *p = params.data();
+    for (size_t i = 0; i < weights.size(); i++) {
+      const int in = dims[i], out = dims[i + 1];
+      Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                               Eigen::RowMajor>,
+                 Eigen::Aligned16>
+          wt(p, out, in);
+      Eigen::Map<Eigen::VectorXd> b(p + out * in, out);
+      wt = weights[i].transpose();
+      b = biases[i];
+      p += mlp_detail::padded(out * in + out);
+    }
+    work[0].setZero(widest);
+    work[1].setZero(widest);
+    ready = true;
+    return ready;
+  }
+
+  bool loaded() const { return ready; }
+  unsigned input_size() const { return dims.empty() ? 0 : dims.front(); }
+  unsigned output_size() const { return dims.empty() ? 0 : dims.back(); }
+
+  /** \brief Evaluate one sample. No heap allocations */
+  void eval(const double *input, double *output) {
+    typedef Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic,
+                                           Eigen::Dynamic, Eigen::RowMajor>,
+                       Eigen::Aligned16>
+        WeightMap;
+    const unsigned layers = dims.size() - 1;
+    const double *p = params.data();
+    const double *src = input;
+
+    for (unsigned i = 0; i < layers; i++) {
+      const int in = dims[i], out = dims[i + 1];
+      const WeightMap wt(p, out, in);
+      const Eigen::Map<const Eigen::VectorXd> b(p + out * in, out);
+      const Eigen::Map<const Eigen::VectorXd> x(src, in);
+
+      double *dst = (i == layers - 1) ? output : work[i & 1].data();
+      Eigen::Map<Eigen::VectorXd> layer(dst, out);
+      layer.noalias() = wt * x;
+      if (i < layers - 1) {
+        layer = (layer + b).cwiseMax(0.0);
+      } else {
+        layer += b;
+      }
+
+      src = dst;
+      p += mlp_detail::padded(out * in + out);
+    }
+  }
+
+ private:
+  std::vector<int> dims;
+  mlp_detail::ParamBlock params;
+  Eigen::VectorXd work[2];
+  bool ready = false;
+};
+
+/** \brief Evaluator specialized for the shipped 12->200->100->34 network */
+typedef MLPEvaluator<12, 200, 100, 34> SmileMLP;
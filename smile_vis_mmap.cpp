@@ -0,0 +1,108 @@
+#include "smile_vis_mmap.h"
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <direct.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool get_file_stamp(const char *file, FileStamp &stamp) {
+  struct stat st;
+  if (stat(file, &st) != 0) return false;
+
+  stamp.size = (uint64_t)st.st_size;
+#if defined(__linux__)
+  stamp.mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#elif defined(__APPLE__)
+  stamp.mtime =
+      (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+  stamp.mtime = (int64_t)st.st_mtime;
+#endif
+  return true;
+}
+
+bool make_directory(const char *directory) {
+#ifdef _WIN32
+  _mkdir(directory);
+#else
+  mkdir(directory, 0755);
+#endif
+  struct stat st;
+  return stat(directory, &st) == 0 && (st.st_mode & S_IFDIR);
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const char *file) {
+  close();
+
+  HANDLE fh = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, NULL,
+                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (fh == INVALID_HANDLE_VALUE) return false;
+
+  LARGE_INTEGER f_size;
+  if (!GetFileSizeEx(fh, &f_size) || f_size.QuadPart == 0) {
+    CloseHandle(fh);
+    return false;
+  }
+
+  HANDLE mh = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (!mh) {
+    CloseHandle(fh);
+    return false;
+  }
+
+  ptr = (const char *)MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+  if (!ptr) {
+    CloseHandle(mh);
+    CloseHandle(fh);
+    return false;
+  }
+  len = (size_t)f_size.QuadPart;
+  file_handle = fh;
+  map_handle = mh;
+  return true;
+}
+
+void MappedFile::close() {
+  if (ptr) UnmapViewOfFile(ptr);
+  if (map_handle) CloseHandle((HANDLE)map_handle);
+  if (file_handle) CloseHandle((HANDLE)file_handle);
+  ptr = nullptr;
+  len = 0;
+  file_handle = map_handle = nullptr;
+}
+#else
+bool MappedFile::open(const char *file) {
+  close();
+
+  const int fd = ::open(file, O_RDONLY);
+  if (fd < 0) return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void *addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // mapping stays valid after the descriptor is closed
+  ::close(fd);
+  if (addr == MAP_FAILED) return false;
+
+  ptr = (const char *)addr;
+  len = (size_t)st.st_size;
+  return true;
+}
+
+void MappedFile::close() {
+  if (ptr) munmap((void *)ptr, len);
+  ptr = nullptr;
+  len = 0;
+}
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/** \brief Size & modification time of a file on disk */
+struct FileStamp {
+  uint64_t size = 0;
+  // ns where the platform records it (rewrites w/in 1 s still differ)
+  int64_t mtime = 0;
+
+  bool operator==(const FileStamp &other) const {
+    return size == other.size && mtime == other.mtime;
+  }
+  bool operator!=(const FileStamp &other) const { return !(*this == other); }
+};
+
+/** \brief Get size & mtime of file (returns false if file doesn't exist) */
+bool get_file_stamp(const char *file, FileStamp &stamp);
+
+/** \brief Create directory (returns true if it exists afterwards) */
+bool make_directory(const char *directory);
+
+/** \brief Read-only memory mapping of a whole file */
+class MappedFile {
+ public:
+  MappedFile() {}
+  ~MappedFile() { close(); }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /** \brief Map file into memory (returns false on failure) */
+  bool open(const char *file);
+
+  /** \brief Unmap file */
+  void close();
+
+  const char *data() const { return ptr; }
+  size_t size() const { return len; }
+  bool is_open() const { return ptr != nullptr; }
+
+ private:
+  const char *ptr = nullptr;
+  size_t len = 0;
+#ifdef _WIN32
+  void *file_handle = nullptr;
+  void *map_handle = nullptr;
+#endif
+};
@@ -0,0 +1,402 @@
+#include "smile_vis_model.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "ddFileIO.h"
+#include "ddTerminal.h"
+#include "smile_vis_data.h"
+
+const char *model_bin_name = "model.svm";
+
+namespace {
+const char model_magic[4] = {'S', 'V', 'M', 'D'};
+const uint32_t model_version = 1;
+const uint64_t blob_align = 64;
+
+inline uint64_t align_up(const uint64_t offset) {
+  return (offset + blob_align - 1) & ~(blob_align - 1);
+}
+
+/** \brief Pull layer index out of file name (e.g. .../w12.csv -> 12) */
+int layer_index(const std::string &path, const char prefix) {
+  const size_t slash = path.find_last_of("\\/");
+  const size_t start = slash == std::string::npos ? 0 : slash + 1;
+  if (path.size() <= start + 1 || path[start] != prefix) return -1;
+
+  char *end = nullptr;
+  const long idx = std::strtol(path.c_str() + start + 1, &end, 10);
+  if (end == path.c_str() + start + 1 || std::strcmp(end, ".csv") != 0) {
+    return -1;
+  }
+  return (int)idx;
+}
+
+/** \brief Write zero padding up to offset */
+void pad_to(FILE *out, const uint64_t offset) {
+  static const char zeros[blob_align] = {0};
+  const uint64_t pos = (uint64_t)ftell(out);
+  if (offset > pos) fwrite(zeros, 1, offset - pos, out);
+}
+
+/** \brief True if any file was modified after mtime */
+bool any_newer(const std::vector<std::string> &files, const int64_t mtime) {
+  FileStamp stamp;
+  for (const std::string &file : files) {
+    if (get_file_stamp(file.c_str(), stamp) && stamp.mtime > mtime) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+std::vector<std::string> get_layer_files(const char *directory,
+                                         const char prefix) {
+  ddIO folder_handle;
+  std::vector<std::pair<int, std::string>> found;
+  if (folder_handle.open(directory, ddIOflag::DIRECTORY)) {
+    dd_array<string512> files = folder_handle.get_directory_files();
+    DD_FOREACH(string512, file, files) {
+      const std::string path = file.ptr->str();
+      const int idx = layer_index(path, prefix);
+      if (idx >= 0) found.push_back(std::make_pair(idx, path));
+    }
+  }
+  std::sort(found.begin(), found.end());
+
+  std::vector<std::string> out(found.size());
+  for (size_t i = 0; i < found.size(); i++) out[i] = found[i].second;
+  return out;
+}
+
+bool MappedModel::open(const char *file_name) {
+  layers = nullptr;
+  n_layers = 0;
+  if (!file.open(file_name)) return false;
+
+  const size_t size = file.size();
+  const ModelFileHeader *header = (const ModelFileHeader *)file.data();
+  if (size < sizeof(ModelFileHeader) ||
+      std::memcmp(header->magic, model_magic, 4) != 0 ||
+      header->version != model_version) {
+    file.close();
+    return false;
+  }
+
+  const uint64_t table_end = sizeof(ModelFileHeader) +
+                             (uint64_t)header->num_layers *
+                                 sizeof(ModelLayerHeader);
+  if (header->num_layers == 0 || table_end > size) {
+    file.close();
+    return false;
+  }
+
+  // validate blob bounds, alignment, shape chain & activations
+  const ModelLayerHeader *table =
+      (const ModelLayerHeader *)(file.data() + sizeof(ModelFileHeader));
+  for (uint32_t l = 0; l < header->num_layers; l++) {
+    const ModelLayerHeader &lh = table[l];
+    const ModelActivation act = l < header->num_layers - 1
+                                    ? ModelActivation::RELU
+                                    : ModelActivation::NONE;
+    const uint64_t w_bytes = (uint64_t)lh.rows * lh.cols * sizeof(double);
+    const uint64_t b_bytes = (uint64_t)lh.cols * sizeof(double);
+    const bool valid =
+        lh.dtype == (uint32_t)ModelDType::F64 &&
+        lh.activation == (uint32_t)act && lh.rows > 0 && lh.cols > 0 &&
+        lh.weight_offset % blob_align == 0 && lh.bias_offset % blob_align == 0 &&
+        lh.weight_offset + w_bytes <= size && lh.bias_offset + b_bytes <= size &&
+        (l == 0 || table[l - 1].cols == lh.rows);
+    if (!valid) {
+      file.close();
+      return false;
+    }
+  }
+
+  layers = table;
+  n_layers = header->num_layers;
+  return true;
+}
+
+MappedModel::WeightView MappedModel::weight(const unsigned layer) const {
+  const ModelLayerHeader &lh = layers[layer];
+  return WeightView((const double *)(file.data() + lh.weight_offset), lh.rows,
+                    lh.cols);
+}
+
+MappedModel::BiasView MappedModel::bias(const unsigned layer) const {
+  const ModelLayerHeader &lh = layers[layer];
+  return BiasView((const double *)(file.data() + lh.bias_offset), lh.cols);
+}
+
+int bad_layer(const std::vector<Eigen::MatrixXd> &weights,
+              const std::vector<Eigen::VectorXd> &biases) {
+  if (weights.size() != biases.size()) {
+    return (int)std::min(weights.size(), biases.size());
+  }
+  for (size_t l = 0; l < weights.size(); l++) {
+    if (weights[l].size() == 0 || weights[l].cols() != biases[l].size() ||
+        (l > 0 && weights[l - 1].cols() != weights[l].rows())) {
+      return (int)l;
+    }
+  }
+  return -1;
+}
+
+void feedForward_models(const FrameSeq &inputs,
+                        const std::vector<const ModelLayers *> &models,
+                        std::vector<RowMatrixXd> &output) {
+  output.resize(models.size());
+  // column range of each model's 1st layer in the fused layer (-1: skipped)
+  std::vector<Eigen::Index> offset(models.size(), -1);
+  Eigen::Index fused_cols = 0;
+  for (size_t m = 0; m < models.size(); m++) {
+    output[m].resize(0, 0);
+    const ModelLayers *model = models[m];
+    if (!model || !model->valid() ||
+        model->weight(0).rows() != inputs.cols()) {
+      continue;
+    }
+    offset[m] = fused_cols;
+    fused_cols += model->weight(0).cols();
+  }
+  if (inputs.empty() || fused_cols == 0) return;
+
+  Eigen::MatrixXd fused_w(inputs.cols(), fused_cols);
+  Eigen::RowVectorXd fused_b(fused_cols);
+  for (size_t m = 0; m < models.size(); m++) {
+    if (offset[m] < 0) continue;
+    const ModelLayers::WeightView w = models[m]->weight(0);
+    fused_w.middleCols(offset[m], w.cols()) = w;
+    fused_b.segment(offset[m], w.cols()) = models[m]->bias(0).transpose();
+  }
+  RowMatrixXd fused;
+  fused.noalias() = inputs.matrix() * fused_w;
+  fused.rowwise() += fused_b;
+
+  RowMatrixXd layerin, layerout;
+  for (size_t m = 0; m < models.size(); m++) {
+    if (offset[m] < 0) continue;
+    const ModelLayers &model = *models[m];
+    const unsigned layers = model.num_layers();
+    const Eigen::Index cols = model.weight(0).cols();
+    if (layers == 1) {
+      output[m] = fused.middleCols(offset[m], cols);
+      continue;
+    }
+
+    // bias + RELU as in feedForward_batch
+    layerin = fused.middleCols(offset[m], cols).cwiseMax(0.0);
+    for (unsigned i = 1; i < layers; i++) {
+      layerout.noalias() = layerin * model.weight(i);
+      if (i + 1 < layers) {
+        layerout =
+            (layerout.rowwise() + model.bias(i).transpose()).cwiseMax(0.0);
+      } else {
+        layerout.rowwise() += model.bias(i).transpose();
+      }
+      layerin.swap(layerout);
+    }
+    output[m].swap(layerin);
+  }
+}
+
+void ModelSource::set_folders(const char *weight_dir, const char *bias_dir) {
+  w_dir = weight_dir;
+  b_dir = bias_dir;
+  w_files.clear();
+  b_files.clear();
+  from_bin = false;
+}
+
+bool ModelSource::reload() {
+  const std::vector<std::string> w_found = get_layer_files(w_dir.c_str(), 'w');
+  const std::vector<std::string> b_found = get_layer_files(b_dir.c_str(), 'b');
+
+  // binary container wins over text files unless a text layer was written
+  // after it (retraining writes text layers next to an exported container)
+  const std::string bin_file = w_dir + "/" + model_bin_name;
+  FileStamp stamp;
+  const bool has_bin = get_file_stamp(bin_file.c_str(), stamp);
+  const bool bin_stale = has_bin && (any_newer(w_found, stamp.mtime) ||
+                                     any_newer(b_found, stamp.mtime));
+  if (has_bin && !bin_stale) {
+    if (from_bin && stamp == bin_stamp) return false;
+    return reload_bin(bin_file, stamp);
+  }
+
+  if (w_found.empty() || w_found.size() != b_found.size()) {
+    ddTerminal::f_post("[error]Model: %s & %s layer count mismatch",
+                       w_dir.c_str(), b_dir.c_str());
+    return false;
+  }
+
+  // unchanged layers are taken from the published model
+  const std::shared_ptr<const ModelLayers> prev = model();
+  std::shared_ptr<ModelLayers> next = std::make_shared<ModelLayers>();
+  const unsigned n_layers = (unsigned)w_found.size();
+  std::vector<LayerFile> w_next(n_layers), b_next(n_layers);
+  unsigned parsed = 0;
+  for (unsigned l = 0; l < n_layers; l++) {
+    w_next[l].file = w_found[l];
+    b_next[l].file = b_found[l];
+    get_file_stamp(w_found[l].c_str(), w_next[l].stamp);
+    get_file_stamp(b_found[l].c_str(), b_next[l].stamp);
+
+    const bool w_same = l < w_files.size() && w_files[l].file == w_found[l] &&
+                        w_files[l].stamp == w_next[l].stamp;
+    const bool b_same = l < b_files.size() && b_files[l].file == b_found[l] &&
+                        b_files[l].stamp == b_next[l].stamp;
+    if (w_same) {
+      next->weights.push_back(prev->weights[l]);
+    } else {
+      next->weights.push_back(extract_matrix(w_found[l].c_str()));
+      parsed++;
+    }
+    if (b_same) {
+      next->biases.push_back(prev->biases[l]);
+    } else {
+      next->biases.push_back(extract_vector(b_found[l].c_str()));
+      parsed++;
+    }
+  }
+  if (parsed == 0 && !from_bin && n_layers == w_files.size()) return false;
+
+  const int bad = bad_layer(next->weights, next->biases);
+  if (bad >= 0) {
+    ddTerminal::f_post("[error]Model: bad shape at layer %d of %s (keeping "
+                       "previous model)",
+                       bad, w_dir.c_str());
+    return false;
+  }
+
+  w_files.swap(w_next);
+  b_files.swap(b_next);
+  from_bin = false;
+  publish(next);
+  if (bin_stale) {
+    ddTerminal::f_post("Model: text layers in %s are newer than %s, using "
+                       "them",
+                       w_dir.c_str(), model_bin_name);
+  }
+  ddTerminal::f_post("Loaded model: %s (%u of %u files read)", w_dir.c_str(),
+                     parsed, n_layers * 2);
+  return true;
+}
+
+bool ModelSource::reload_bin(const std::string &bin_file,
+                             const FileStamp &stamp) {
+  // open() checks bounds & the shape chain, blobs are used in place
+  std::shared_ptr<MappedModel> mapped = std::make_shared<MappedModel>();
+  if (!mapped->open(bin_file.c_str())) {
+    ddTerminal::f_post("[error]Model: can't read %s", bin_file.c_str());
+    return false;
+  }
+
+  std::shared_ptr<ModelLayers> next = std::make_shared<ModelLayers>();
+  next->mapped = mapped;
+
+  w_files.clear();
+  b_files.clear();
+  bin_stamp = stamp;
+  from_bin = true;
+  publish(next);
+  ddTerminal::f_post("Loaded binary model: %s", bin_file.c_str());
+  return true;
+}
+
+void ModelLayers::copy_to(std::vector<Eigen::MatrixXd> &w,
+                          std::vector<Eigen::VectorXd> &b) const {
+  const unsigned layers = num_layers();
+  w.resize(layers);
+  b.resize(layers);
+  for (unsigned l = 0; l < layers; l++) {
+    w[l] = weight(l);
+    b[l] = bias(l);
+  }
+}
+
+std::shared_ptr<const ModelLayers> ModelSource::model() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return current;
+}
+
+void ModelSource::publish(std::shared_ptr<const ModelLayers> next) {
+  std::lock_guard<std::mutex> lock(mutex);
+  current = next;
+}
+
+bool convert_model(const char *weight_dir, const char *bias_dir,
+                   const char *out_file) {
+  std::vector<std::string> w_files = get_layer_files(weight_dir, 'w');
+  std::vector<std::string> b_files = get_layer_files(bias_dir, 'b');
+  if (w_files.empty() || w_files.size() != b_files.size()) {
+    ddTerminal::f_post("[error]Model convert: %s & %s layer count mismatch",
+                       weight_dir, bias_dir);
+    return false;
+  }
+
+  // parse text layers & check shape chain
+  const unsigned n_layers = w_files.size();
+  std::vector<Eigen::MatrixXd> weights(n_layers);
+  std::vector<Eigen::VectorXd> biases(n_layers);
+  for (unsigned l = 0; l < n_layers; l++) {
+    weights[l] = extract_matrix(w_files[l].c_str());
+    biases[l] = extract_vector(b_files[l].c_str());
+  }
+  const int bad = bad_layer(weights, biases);
+  if (bad >= 0) {
+    ddTerminal::f_post("[error]Model convert: bad shape at layer %d", bad);
+    return false;
+  }
+
+  // lay out header, layer table & aligned blobs
+  ModelFileHeader header;
+  std::memcpy(header.magic, model_magic, 4);
+  header.version = model_version;
+  header.num_layers = n_layers;
+  header.reserved = 0;
+
+  std::vector<ModelLayerHeader> table(n_layers);
+  uint64_t offset =
+      sizeof(ModelFileHeader) + n_layers * sizeof(ModelLayerHeader);
+  for (unsigned l = 0; l < n_layers; l++) {
+    table[l].rows = weights[l].rows();
+    table[l].cols = weights[l].cols();
+    table[l].dtype = (uint32_t)ModelDType::F64;
+    table[l].activation = (uint32_t)(l < n_layers - 1 ? ModelActivation::RELU
+                                                      : ModelActivation::NONE);
+    table[l].weight_offset = offset = align_up(offset);
+    offset += weights[l].size() * sizeof(double);
+    table[l].bias_offset = offset = align_up(offset);
+    offset += biases[l].size() * sizeof(double);
+  }
+
+  // write to temp file & rename so a mapped or watched model.svm is never
+  // truncated or seen half-written
+  string512 tmp_file;
+  tmp_file.format("%s.tmp", out_file);
+  FILE *out = std::fopen(tmp_file.str(), "wb");
+  if (!out) {
+    ddTerminal::f_post("[error]Model convert: can't write %s", tmp_file.str());
+    return false;
+  }
+  std::fwrite(&header, sizeof(header), 1, out);
+  std::fwrite(table.data(), sizeof(ModelLayerHeader), n_layers, out);
+  for (unsigned l = 0; l < n_layers; l++) {
+    pad_to(out, table[l].weight_offset);
+    std::fwrite(weights[l].data(), sizeof(double), weights[l].size(), out);
+    pad_to(out, table[l].bias_offset);
+    std::fwrite(biases[l].data(), sizeof(double), biases[l].size(), out);
+  }
+  bool success = std::ferror(out) == 0;
+  success = std::fclose(out) == 0 && success;
+
+  if (!success || std::rename(tmp_file.str(), out_file) != 0) {
+    std::remove(tmp_file.str());
+    ddTerminal::f_post("[error]Model convert: can't write %s", out_file);
+    return false;
+  }
+  ddTerminal::f_post("Model convert: %s (%u layers)", out_file, n_layers);
+  return true;
+}
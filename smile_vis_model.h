@@ -0,0 +1,193 @@
+#pragma once
+
+#include "Eigen/Core"
+#include "smile_vis_data.h"
+#include "smile_vis_mmap.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Binary model container (*.svm)
+ *
+ *   ModelFileHeader
+ *   ModelLayerHeader[num_layers]
+ *   per layer: weight blob (rows x cols, column-major), bias blob (cols)
+ *
+ * Every blob starts on a 64 byte boundary & uses Eigen's default storage
+ * order, so a mapped file can be used in place thru Eigen::Map. The
+ * evaluators always apply ReLU between layers & none after the last, so
+ * containers declaring any other activation layout are rejected on open.
+ */
+
+/** \brief Default file name of the container inside a weight folder */
+extern const char *model_bin_name;
+
+enum class ModelDType : uint32_t { F64 = 0, F32 = 1 };
+enum class ModelActivation : uint32_t { NONE = 0, RELU = 1 };
+
+struct ModelFileHeader {
+  char magic[4];  //< "SVMD"
+  uint32_t version;
+  uint32_t num_layers;
+  uint32_t reserved;
+};
+
+struct ModelLayerHeader {
+  uint32_t rows;        //< layer input size
+  uint32_t cols;        //< layer output size
+  uint32_t dtype;       //< ModelDType
+  uint32_t activation;  //< ModelActivation
+  uint64_t weight_offset;
+  uint64_t bias_offset;
+};
+
+/** \brief Read-only view of a memory mapped model container */
+class MappedModel {
+ public:
+  typedef Eigen::Map<const Eigen::MatrixXd, Eigen::Aligned16> WeightView;
+  typedef Eigen::Map<const Eigen::VectorXd, Eigen::Aligned16> BiasView;
+
+  /** \brief Map & validate container (returns false if missing/corrupt) */
+  bool open(const char *file);
+
+  unsigned num_layers() const { return n_layers; }
+  WeightView weight(const unsigned layer) const;
+  BiasView bias(const unsigned layer) const;
+  ModelActivation activation(const unsigned layer) const {
+    return (ModelActivation)layers[layer].activation;
+  }
+
+ private:
+  MappedFile file;
+  const ModelLayerHeader *layers = nullptr;
+  unsigned n_layers = 0;
+};
+
+/**
+ * \brief Collect layer files (<prefix>0.csv, <prefix>1.csv, ...) in index
+ * order
+ */
+std::vector<std::string> get_layer_files(const char *directory,
+                                         const char prefix);
+
+/**
+ * \brief First layer that breaks the shape chain (-1 if all fit)
+ *
+ * Layer l must map the previous output (weights[l - 1].cols()) to
+ * biases[l].size() values & there must be a bias per weight.
+ */
+int bad_layer(const std::vector<Eigen::MatrixXd> &weights,
+              const std::vector<Eigen::VectorXd> &biases);
+
+/**
+ * Weights & biases of 1 network (never modified once published)
+ *
+ * Layers are either owned (parsed text layers) or used in place from a
+ * mapped container, which stays mapped as long as the ModelLayers lives
+ * (weights & biases are empty then). Read them thru weight()/bias(),
+ * copy_to() is for consumers that need owned matrices.
+ */
+struct ModelLayers {
+  typedef MappedModel::WeightView WeightView;
+  typedef MappedModel::BiasView BiasView;
+
+  std::vector<Eigen::MatrixXd> weights;
+  std::vector<Eigen::VectorXd> biases;
+  std::shared_ptr<const MappedModel> mapped;
+
+  unsigned num_layers() const {
+    return mapped ? mapped->num_layers() : (unsigned)weights.size();
+  }
+  WeightView weight(const unsigned layer) const {
+    if (mapped) return mapped->weight(layer);
+    const Eigen::MatrixXd &w = weights[layer];
+    return WeightView(w.data(), w.rows(), w.cols());
+  }
+  BiasView bias(const unsigned layer) const {
+    if (mapped) return mapped->bias(layer);
+    return BiasView(biases[layer].data(), biases[layer].size());
+  }
+  /** \brief Layers & biases are consistent (mapped ones checked on open) */
+  bool valid() const {
+    return mapped || (!weights.empty() && bad_layer(weights, biases) < 0);
+  }
+
+  /** \brief Owned copy of every layer */
+  void copy_to(std::vector<Eigen::MatrixXd> &w,
+               std::vector<Eigen::VectorXd> &b) const;
+};
+
+/**
+ * \brief Pipe every row of a sequence thru several nets in 1 pass
+ * \param output output[m] holds the predictions of models[m] (empty if the
+ *        model is empty, inconsistent or takes a different input width)
+ *
+ * The 1st layers of all models are fused side by side, so the input block
+ * is read by a single GEMM however many models there are. The deeper layers
+ * of each model then run as 1 GEMM per layer over all frames (like
+ * feedForward_batch). Models don't share weights, so those GEMMs can't be
+ * merged w/o multiplying zeros (block diagonal) & cost grows about linearly
+ * w/ the model count: 4 copies of the 12-200-100-34 net take ~3.5-4x 1
+ * feedForward_batch (bench case feedForward_models/4). Double precision
+ * only, the float32/int8 backends evaluate 1 model at a time.
+ */
+void feedForward_models(const FrameSeq &inputs,
+                        const std::vector<const ModelLayers *> &models,
+                        std::vector<RowMatrixXd> &output);
+
+/**
+ * Network loaded from a weight & bias folder pair
+ *
+ * Layers come from the binary container in the weight folder if present &
+ * no text layer is newer than it, else from the text layers in file index
+ * order (so retrained text layers win over a previously exported
+ * container). The shape chain is checked before a model is published.
+ * reload() only re-parses layer files whose size or mtime changed, & keeps
+ * the previous model if the new files are incomplete or inconsistent (e.g.
+ * still being written). Published models are immutable & shared, so readers
+ * keep the one they hold while a new one is swapped in.
+ *
+ * model() is thread safe, reload() must not run on 2 threads at once.
+ */
+class ModelSource {
+ public:
+  ModelSource() : current(std::make_shared<const ModelLayers>()) {}
+
+  /** \brief Set folders (next reload reads every layer) */
+  void set_folders(const char *weight_dir, const char *bias_dir);
+
+  /** \brief Re-read changed layers (true if a new model was published) */
+  bool reload();
+
+  /** \brief Current model (empty before the 1st successful load) */
+  std::shared_ptr<const ModelLayers> model() const;
+
+  const std::string &weight_folder() const { return w_dir; }
+  const std::string &bias_folder() const { return b_dir; }
+
+ private:
+  struct LayerFile {
+    std::string file;
+    FileStamp stamp;
+  };
+
+  bool reload_bin(const std::string &bin_file, const FileStamp &stamp);
+  void publish(std::shared_ptr<const ModelLayers> next);
+
+  std::string w_dir;
+  std::string b_dir;
+  // sources of the published model (text layers or container)
+  std::vector<LayerFile> w_files;
+  std::vector<LayerFile> b_files;
+  FileStamp bin_stamp;
+  bool from_bin = false;
+
+  mutable std::mutex mutex;
+  std::shared_ptr<const ModelLayers> current;
+};
+
+/** \brief Build binary container from weight/ & bias/ text folders */
+bool convert_model(const char *weight_dir, const char *bias_dir,
+                   const char *out_file);
@@ -0,0 +1,76 @@
+#include "smile_vis_playback.h"
+#include <algorithm>
+#include <cmath>
+
+const char *play_mode_names[(unsigned)PlayMode::COUNT] = {"real-time",
+                                                          "scaled", "step"};
+
+bool build_time_index(const RowMatrixXd &rows, const int column,
+                      const double frame_rate, std::vector<double> &out) {
+  const unsigned frames = (unsigned)rows.rows();
+  out.resize(frames);
+  if (frames == 0) return false;
+
+  if (column >= 0 && column < rows.cols()) {
+    const double start = rows(0, column);
+    bool sorted = std::isfinite(start);
+    for (unsigned f = 0; f < frames && sorted; f++) {
+      out[f] = rows(f, column) - start;
+      sorted = std::isfinite(out[f]) && (f == 0 || out[f] > out[f - 1]);
+    }
+    if (sorted) return true;
+  }
+
+  const double dt = 1.0 / std::max(frame_rate, 1e-3);
+  for (unsigned f = 0; f < frames; f++) out[f] = f * dt;
+  return false;
+}
+
+void Playback::set_index(std::vector<double> &times) {
+  stamps.swap(times);
+  // hold last frame for the mean interval
+  const size_t n = stamps.size();
+  span = n > 1 ? stamps.back() * n / (n - 1) : 0.0;
+  clock = 0.0;
+  locate();
+}
+
+void Playback::update(const double dt) {
+  if (!playing || mode == PlayMode::STEP) return;
+  seek(clock + dt * (mode == PlayMode::SCALED ? speed : 1.f));
+}
+
+void Playback::seek(const double t) {
+  clock = span > 0.0 ? t - std::floor(t / span) * span : 0.0;
+  locate();
+}
+
+void Playback::seek_frame(const unsigned frame) {
+  if (stamps.empty()) return;
+  clock = stamps[std::min(frame, (unsigned)stamps.size() - 1)];
+  locate();
+}
+
+void Playback::step(const int n) {
+  playing = false;
+  if (stamps.empty()) return;
+  const int count = (int)stamps.size();
+  seek_frame((unsigned)((((int)curr.frame + n) % count + count) % count));
+}
+
+void Playback::locate() {
+  curr = PlaySample();
+  if (stamps.empty()) return;
+
+  // last sample at or before the clock (equal stamps resolve to the last)
+  const std::vector<double>::const_iterator it =
+      std::upper_bound(stamps.begin(), stamps.end(), clock);
+  curr.frame = it == stamps.begin() ? 0 : (unsigned)(it - stamps.begin()) - 1;
+  curr.next = curr.frame;
+  if (curr.frame + 1 < stamps.size()) {
+    const double t0 = stamps[curr.frame];
+    const double t1 = stamps[curr.frame + 1];
+    curr.next = curr.frame + 1;
+    curr.blend = t1 > t0 ? (float)((clock - t0) / (t1 - t0)) : 0.f;
+  }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include "smile_vis_data.h"
+
+/** \brief How the playback clock advances */
+enum class PlayMode : unsigned {
+  REALTIME = 0,  // capture time == wall clock
+  SCALED,        // wall clock * speed
+  STEP,          // clock only moves on step()/seek()
+  COUNT
+};
+
+extern const char *play_mode_names[(unsigned)PlayMode::COUNT];
+
+/**
+ * \brief Frame timestamps (s, 1st frame at 0) of a sequence
+ * \param column Time column of rows (< 0: none)
+ * \param frame_rate Used if there is no usable time column
+ * \return true if the timestamps came from the time column
+ *
+ * Every frame must map to its own time for lookups & stepping, so a column
+ * that isn't strictly increasing (duplicate stamps, non-finite values) is
+ * rejected in favour of the fixed rate.
+ */
+bool build_time_index(const RowMatrixXd &rows, const int column,
+                      const double frame_rate, std::vector<double> &out);
+
+/** \brief Samples around the playback time & blend between them */
+struct PlaySample {
+  unsigned frame = 0;
+  unsigned next = 0;
+  // 0: frame, 1: next
+  float blend = 0.f;
+};
+
+/**
+ * Transport over the time index of the displayed sequence
+ *
+ * The clock is in capture seconds. Every clock change locates the
+ * surrounding samples w/ a binary search (O(log n)), so readers just fetch
+ * the cached sample. Playback loops, the last frame is held for the mean
+ * frame interval before wrapping.
+ */
+class Playback {
+ public:
+  /** \brief Take over time index (clock restarts at 0) */
+  void set_index(std::vector<double> &times);
+
+  /** \brief Advance by wall clock seconds (unless paused or stepping) */
+  void update(const double dt);
+
+  /** \brief Jump to capture time (wrapped into the sequence) */
+  void seek(const double t);
+
+  /** \brief Jump to start of frame */
+  void seek_frame(const unsigned frame);
+
+  /** \brief Move n frames (wraps) & pause */
+  void step(const int n);
+
+  const PlaySample &sample() const { return curr; }
+  double time() const { return clock; }
+  /** \brief Length of 1 loop (s) */
+  double duration() const { return span; }
+  unsigned frames() const { return (unsigned)stamps.size(); }
+
+  PlayMode mode = PlayMode::REALTIME;
+  // clock multiplier in SCALED mode
+  float speed = 1.f;
+  bool playing = true;
+
+ private:
+  void locate();
+
+  std::vector<double> stamps;
+  double span = 0.0;
+  double clock = 0.0;
+  PlaySample curr;
+};
@@ -0,0 +1,260 @@
+#include "smile_vis_quant.h"
+#include <chrono>
+#include <cmath>
+#include "ddFileIO.h"
+#include "ddTerminal.h"
+#include "smile_vis_data.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define SVIS_AVX2
+#endif
+
+const char *inference_mode_names[(unsigned)InferenceMode::COUNT] = {
+    "double", "float32", "int8"};
+
+namespace {
+// network inputs in the column order of the input/ csv files
+const char *input_columns[] = {
+    "Oral commisure (L) x",   "Oral commisure (L) y",
+    "Oral commisure (R) x",   "Oral commisure (R) y",
+    "Iris (M) x",             "Iris (M) y",
+    "Iris (L) x",             "Iris (L) y",
+    "Dental show (Top) x",    "Dental show (Top) y",
+    "Dental show (Bottom) x", "Dental show (Bottom) y"};
+const unsigned num_input_columns =
+    sizeof(input_columns) / sizeof(input_columns[0]);
+
+/** \brief Rows are padded to 16 lanes (2 x AVX floats or 16 x int8) */
+inline unsigned pad_row(const unsigned n) { return (n + 15) & ~15u; }
+
+#ifdef SVIS_AVX2
+inline float hsum(const __m256 v) {
+  __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+  lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 0x1));
+  return _mm_cvtss_f32(lo);
+}
+#endif
+
+/** \brief Dot product of padded float rows */
+inline float dot_f32(const float *w, const float *x, const unsigned n) {
+#ifdef SVIS_AVX2
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (unsigned i = 0; i < n; i += 16) {
+    acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(w + i), _mm256_loadu_ps(x + i), acc0);
+    acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(w + i + 8),
+                           _mm256_loadu_ps(x + i + 8), acc1);
+  }
+  return hsum(_mm256_add_ps(acc0, acc1));
+#else
+  float acc = 0.f;
+  for (unsigned i = 0; i < n; i++) acc += w[i] * x[i];
+  return acc;
+#endif
+}
+
+/** \brief Dot product of padded int8 weight row & float activations */
+inline float dot_i8(const int8_t *w, const float *x, const unsigned n) {
+#ifdef SVIS_AVX2
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  for (unsigned i = 0; i < n; i += 16) {
+    const __m128i q = _mm_loadu_si128((const __m128i *)(w + i));
+    const __m256 w0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q));
+    const __m256 w1 =
+        _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(q, 8)));
+    acc0 = _mm256_fmadd_ps(w0, _mm256_loadu_ps(x + i), acc0);
+    acc1 = _mm256_fmadd_ps(w1, _mm256_loadu_ps(x + i + 8), acc1);
+  }
+  return hsum(_mm256_add_ps(acc0, acc1));
+#else
+  float acc = 0.f;
+  for (unsigned i = 0; i < n; i++) acc += (float)w[i] * x[i];
+  return acc;
+#endif
+}
+
+/** \brief y = max(y + b, 0) over padded activations (tail is zeroed) */
+inline void bias_relu(float *y, const float *b, const unsigned n,
+                      const unsigned padded_n) {
+  unsigned i = 0;
+#ifdef SVIS_AVX2
+  const __m256 zero = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    const __m256 v = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_loadu_ps(b + i));
+    _mm256_storeu_ps(y + i, _mm256_max_ps(v, zero));
+  }
+#endif
+  for (; i < n; i++) y[i] = std::max(y[i] + b[i], 0.f);
+  for (; i < padded_n; i++) y[i] = 0.f;
+}
+}  // namespace
+
+bool ReducedMLP::prepare(const std::vector<Eigen::MatrixXd> &weights,
+                         const std::vector<Eigen::VectorXd> &biases,
+                         const InferenceMode _mode) {
+  mode = _mode;
+  layers.clear();
+  if (weights.empty() || weights.size() != biases.size()) return false;
+
+  unsigned widest = 0;
+  layers.resize(weights.size());
+  for (unsigned l = 0; l < weights.size(); l++) {
+    Layer &layer = layers[l];
+    layer.in = weights[l].rows();
+    layer.out = weights[l].cols();
+    layer.stride = pad_row(layer.in);
+    if (biases[l].size() != layer.out ||
+        (l > 0 && layer.in != layers[l - 1].out)) {
+      layers.clear();
+      return false;
+    }
+    widest = std::max(widest, std::max(layer.stride, pad_row(layer.out)));
+
+    layer.bias.resize(layer.out);
+    for (unsigned j = 0; j < layer.out; j++) layer.bias[j] = biases[l](j);
+
+    if (mode == InferenceMode::INT8) {
+      // symmetric per output channel quantization
+      layer.w_i8.assign(layer.out * layer.stride, 0);
+      layer.scale.resize(layer.out);
+      for (unsigned j = 0; j < layer.out; j++) {
+        const double max_w = weights[l].col(j).cwiseAbs().maxCoeff();
+        const double scale = max_w > 0.0 ? max_w / 127.0 : 1.0;
+        layer.scale[j] = (float)scale;
+        for (unsigned k = 0; k < layer.in; k++) {
+          const long q = std::lround(weights[l](k, j) / scale);
+          layer.w_i8[j * layer.stride + k] =
+              (int8_t)std::max(-127l, std::min(127l, q));
+        }
+      }
+    } else {
+      layer.w_f32.assign(layer.out * layer.stride, 0.f);
+      for (unsigned j = 0; j < layer.out; j++) {
+        for (unsigned k = 0; k < layer.in; k++) {
+          layer.w_f32[j * layer.stride + k] = (float)weights[l](k, j);
+        }
+      }
+    }
+  }
+  work[0].assign(widest, 0.f);
+  work[1].assign(widest, 0.f);
+  return true;
+}
+
+void ReducedMLP::eval(const double *input, double *output) {
+  float *src = work[0].data();
+  float *dst = work[1].data();
+  for (unsigned k = 0; k < layers[0].in; k++) src[k] = (float)input[k];
+
+  const unsigned num_layers = layers.size();
+  for (unsigned l = 0; l < num_layers; l++) {
+    const Layer &layer = layers[l];
+    if (mode == InferenceMode::INT8) {
+      for (unsigned j = 0; j < layer.out; j++) {
+        dst[j] = dot_i8(&layer.w_i8[j * layer.stride], src, layer.stride) *
+                 layer.scale[j];
+      }
+    } else {
+      for (unsigned j = 0; j < layer.out; j++) {
+        dst[j] = dot_f32(&layer.w_f32[j * layer.stride], src, layer.stride);
+      }
+    }
+
+    if (l < num_layers - 1) {
+      bias_relu(dst, layer.bias.data(), layer.out, pad_row(layer.out));
+      std::swap(src, dst);
+    } else {
+      for (unsigned j = 0; j < layer.out; j++) {
+        output[j] = (double)(dst[j] + layer.bias[j]);
+      }
+    }
+  }
+}
+
+std::vector<double> feedForward(
+    const Eigen::Ref<const Eigen::VectorXd> &inputs, ReducedMLP &model) {
+  std::vector<double> output(model.layers.back().out);
+  model.eval(inputs.data(), output.data());
+  return output;
+}
+
+std::vector<AccuracyStats> report_inference_accuracy(
+    const char *data_dir, std::vector<Eigen::MatrixXd> &weights,
+    std::vector<Eigen::VectorXd> &biases) {
+  typedef std::chrono::high_resolution_clock clock;
+  std::vector<AccuracyStats> stats((unsigned)InferenceMode::COUNT);
+
+  ReducedMLP reduced[(unsigned)InferenceMode::COUNT];
+  for (unsigned m = 0; m < stats.size(); m++) {
+    stats[m].mode = (InferenceMode)m;
+    if (m != (unsigned)InferenceMode::DOUBLE) {
+      if (!reduced[m].prepare(weights, biases, (InferenceMode)m)) {
+        ddTerminal::post("[error]Accuracy report: invalid network");
+        return std::vector<AccuracyStats>();
+      }
+    }
+  }
+
+  ddIO folder_handle;
+  if (!folder_handle.open(data_dir, ddIOflag::DIRECTORY)) {
+    ddTerminal::f_post("[error]Accuracy report: can't open %s", data_dir);
+    return std::vector<AccuracyStats>();
+  }
+  dd_array<string512> files = folder_handle.get_directory_files();
+
+  std::vector<double> ref, out;
+  double dev_sum[(unsigned)InferenceMode::COUNT] = {0.0};
+  double time_ns[(unsigned)InferenceMode::COUNT] = {0.0};
+  unsigned long landmarks = 0;
+
+  DD_FOREACH(string512, file, files) {
+    if (!file.ptr->contains(".csv")) continue;
+
+    // only the network input columns are converted
+    const FrameSeq frames =
+        extract_columns(file.ptr->str(), input_columns, num_input_columns);
+    if (frames.empty()) continue;
+    for (unsigned m = 0; m < stats.size(); m++) stats[m].files++;
+
+    for (unsigned r = 0; r < frames.size(); r++) {
+      clock::time_point t0 = clock::now();
+      ref = feedForward(frames[r], weights, biases);
+      time_ns[0] +=
+          std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+      stats[0].frames++;
+      landmarks += ref.size() / 2;
+
+      for (unsigned m = 1; m < stats.size(); m++) {
+        t0 = clock::now();
+        out = feedForward(frames[r], reduced[m]);
+        time_ns[m] += std::chrono::duration<double, std::nano>(
+                          clock::now() - t0)
+                          .count();
+        stats[m].frames++;
+
+        for (unsigned p = 0; p + 1 < ref.size(); p += 2) {
+          const double dev = std::hypot(out[p] - ref[p], out[p + 1] - ref[p + 1]);
+          dev_sum[m] += dev;
+          stats[m].max_dev = std::max(stats[m].max_dev, dev);
+        }
+      }
+    }
+  }
+
+  ddTerminal::f_post("Inference accuracy vs double (%u files, %u frames):",
+                     stats[0].files, stats[0].frames);
+  for (unsigned m = 0; m < stats.size(); m++) {
+    if (stats[m].frames > 0) {
+      stats[m].ns_per_frame = time_ns[m] / stats[m].frames;
+    }
+    if (landmarks > 0) stats[m].mean_dev = dev_sum[m] / landmarks;
+    ddTerminal::f_post("  %-8s: max %.5f px, mean %.5f px, %.0f ns/frame",
+                       inference_mode_names[m], stats[m].max_dev,
+                       stats[m].mean_dev, stats[m].ns_per_frame);
+  }
+
+  return stats;
+}
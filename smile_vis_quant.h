@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Eigen/Core"
+#include <cstdint>
+#include <vector>
+
+/** \brief Numeric backend used for running the network */
+enum class InferenceMode : unsigned { DOUBLE, FLOAT32, INT8, COUNT };
+
+/** \brief Display names for InferenceMode (indexed by enum value) */
+extern const char *inference_mode_names[(unsigned)InferenceMode::COUNT];
+
+/**
+ * \brief Reduced precision copy of the network
+ *
+ * FLOAT32 keeps float weights. INT8 stores weights as int8 w/ one scale per
+ * output channel (activations stay float32, so the raw pixel inputs keep
+ * their precision). Rows are padded to the SIMD width and pre-transposed
+ * (out x in) so every output is one contiguous dot product.
+ */
+struct ReducedMLP {
+  struct Layer {
+    unsigned in = 0;
+    unsigned out = 0;
+    unsigned stride = 0;       //< padded row length
+    std::vector<float> w_f32;  //< FLOAT32 weights (out x stride)
+    std::vector<int8_t> w_i8;  //< INT8 weights (out x stride)
+    std::vector<float> scale;  //< INT8 per output channel scale
+    std::vector<float> bias;
+  };
+
+  InferenceMode mode = InferenceMode::FLOAT32;
+  std::vector<Layer> layers;
+  std::vector<float> work[2];
+
+  /** \brief Build reduced copy of double precision weights */
+  bool prepare(const std::vector<Eigen::MatrixXd> &weights,
+               const std::vector<Eigen::VectorXd> &biases,
+               const InferenceMode _mode);
+
+  /** \brief Run 1 sample (input & output in double for drop-in use) */
+  void eval(const double *input, double *output);
+};
+
+/** \brief Pipe input thru reduced precision network */
+std::vector<double> feedForward(
+    const Eigen::Ref<const Eigen::VectorXd> &inputs, ReducedMLP &model);
+
+/** \brief Deviation of one backend from the double precision path */
+struct AccuracyStats {
+  InferenceMode mode = InferenceMode::DOUBLE;
+  unsigned files = 0;
+  unsigned frames = 0;
+  double max_dev = 0.0;      //< max landmark distance (px)
+  double mean_dev = 0.0;     //< mean landmark distance (px)
+  double ns_per_frame = 0.0; //< average inference time
+};
+
+/** \brief Run every csv in data_dir thru each backend & compare to double */
+std::vector<AccuracyStats> report_inference_accuracy(
+    const char *data_dir, std::vector<Eigen::MatrixXd> &weights,
+    std::vector<Eigen::VectorXd> &biases);
@@ -0,0 +1,169 @@
+#include "smile_vis_seqcache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include "smile_vis_mmap.h"
+
+namespace {
+const char cache_magic[4] = {'S', 'V', 'S', 'C'};
+const uint32_t cache_version = 1;
+const uint64_t payload_align = 64;
+const unsigned name_len = 64;
+
+struct SeqCacheHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t src_size;
+  int64_t src_mtime;
+  uint32_t rows;
+  uint32_t cols;
+  uint32_t type;       //< VectorOut used to parse the source
+  uint32_t num_names;  //< column names (0 for headerless files)
+  uint64_t data_offset;
+  char source[512];
+};
+
+/** \brief Copy string into zeroed fixed size field (truncated, always
+ * terminated) */
+void copy_field(char *dst, const size_t size, const char *src) {
+  std::memcpy(dst, src, std::min(std::strlen(src), size - 1));
+}
+
+std::mutex cache_dir_mutex;
+string512 cache_dir;
+
+/** \brief Cache file path for src_file (false if caching is disabled) */
+bool get_cache_path(const char *src_file, string512 &out) {
+  std::lock_guard<std::mutex> lock(cache_dir_mutex);
+  if (!*cache_dir.str()) return false;
+
+  // <parent folder>_<file name> keeps input/ & ground_truth/ files apart
+  const char *name = src_file;
+  const char *parent = src_file;
+  for (const char *c = src_file; *c; c++) {
+    if (*c == '/' || *c == '\\') {
+      parent = name;
+      name = c + 1;
+    }
+  }
+  string512 prefix;
+  const size_t parent_len = name > parent ? (size_t)(name - parent - 1) : 0;
+  if (parent_len > 0 && parent_len < 256) {
+    char buff[256];
+    std::memcpy(buff, parent, parent_len);
+    buff[parent_len] = '\0';
+    prefix.format("%s_", buff);
+  }
+
+  out.format("%s/%s%s.svc", cache_dir.str(), prefix.str(), name);
+  return true;
+}
+}  // namespace
+
+void set_seq_cache_dir(const char *directory) {
+  std::lock_guard<std::mutex> lock(cache_dir_mutex);
+  cache_dir = directory ? directory : "";
+  if (*cache_dir.str()) make_directory(cache_dir.str());
+}
+
+bool load_seq_cache(const char *src_file, const VectorOut type,
+                    dd_array<string64> &names,
+                    FrameSeq &rows) {
+  string512 cache_file;
+  FileStamp stamp;
+  if (!get_cache_path(src_file, cache_file) ||
+      !get_file_stamp(src_file, stamp)) {
+    return false;
+  }
+
+  MappedFile mapped;
+  if (!mapped.open(cache_file.str())) return false;
+
+  // validate against current state of source file
+  const SeqCacheHeader *header = (const SeqCacheHeader *)mapped.data();
+  if (mapped.size() < sizeof(SeqCacheHeader) ||
+      std::memcmp(header->magic, cache_magic, 4) != 0 ||
+      header->version != cache_version || header->type != (uint32_t)type ||
+      header->src_size != stamp.size || header->src_mtime != stamp.mtime ||
+      std::strncmp(header->source, src_file, sizeof(header->source)) != 0) {
+    return false;
+  }
+  const uint64_t names_end =
+      sizeof(SeqCacheHeader) + (uint64_t)header->num_names * name_len;
+  const uint64_t data_end = header->data_offset + (uint64_t)header->rows *
+                                                      header->cols *
+                                                      sizeof(double);
+  if (names_end > header->data_offset || data_end > mapped.size()) {
+    return false;
+  }
+
+  const char *cached_names = mapped.data() + sizeof(SeqCacheHeader);
+  names.resize(header->num_names);
+  for (unsigned i = 0; i < header->num_names; i++) {
+    char name[name_len];
+    std::memcpy(name, cached_names + i * name_len, name_len);
+    name[name_len - 1] = '\0';
+    names[i] = name;
+  }
+
+  const double *payload =
+      (const double *)(mapped.data() + header->data_offset);
+  // payload layout matches FrameSeq, so it's a single copy
+  rows.resize(header->rows, header->cols);
+  std::memcpy(rows.row_data(0), payload,
+              (size_t)header->rows * header->cols * sizeof(double));
+  return true;
+}
+
+bool save_seq_cache(const char *src_file, const VectorOut type,
+                    const dd_array<string64> &names,
+                    const FrameSeq &rows) {
+  string512 cache_file;
+  FileStamp stamp;
+  if (rows.empty() || !get_cache_path(src_file, cache_file) ||
+      !get_file_stamp(src_file, stamp)) {
+    return false;
+  }
+
+  SeqCacheHeader header = {};
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, cache_magic, 4);
+  header.version = cache_version;
+  header.src_size = stamp.size;
+  header.src_mtime = stamp.mtime;
+  header.rows = rows.size();
+  header.cols = rows.cols();
+  header.type = (uint32_t)type;
+  header.num_names = names.size();
+  copy_field(header.source, sizeof(header.source), src_file);
+  const uint64_t names_end =
+      sizeof(SeqCacheHeader) + (uint64_t)header.num_names * name_len;
+  header.data_offset =
+      (names_end + payload_align - 1) & ~(payload_align - 1);
+
+  // write to temp file & rename so readers never see a partial cache
+  string512 tmp_file;
+  tmp_file.format("%s.tmp", cache_file.str());
+  FILE *out = std::fopen(tmp_file.str(), "wb");
+  if (!out) return false;
+
+  std::fwrite(&header, sizeof(header), 1, out);
+  for (unsigned i = 0; i < names.size(); i++) {
+    char name[name_len] = {0};
+    copy_field(name, name_len, names[i].str());
+    std::fwrite(name, 1, name_len, out);
+  }
+  static const char zeros[payload_align] = {0};
+  std::fwrite(zeros, 1, header.data_offset - names_end, out);
+  std::fwrite(rows.row_data(0), sizeof(double),
+              (size_t)header.rows * header.cols, out);
+  const bool success = std::ferror(out) == 0;
+  std::fclose(out);
+
+  if (!success || std::rename(tmp_file.str(), cache_file.str()) != 0) {
+    std::remove(tmp_file.str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "smile_vis_data.h"
+
+/**
+ * Binary cache for parsed landmark csv files (*.svc)
+ *
+ *   SeqCacheHeader (source path, size & mtime, shape, parse type)
+ *   column names (cols x 64 chars, none for headerless canonical files)
+ *   payload: rows x cols float64, row-major, 64 byte aligned
+ *
+ * Caches live in one folder (not next to the csv) so they never show up in
+ * the data file lists. They're keyed by <parent folder>_<file name> & are
+ * rebuilt whenever the source size or mtime changes.
+ */
+
+/** \brief Set folder for sequence caches (nullptr/empty disables caching) */
+void set_seq_cache_dir(const char *directory);
+
+/** \brief Load parsed csv from cache (returns false if missing or stale) */
+bool load_seq_cache(const char *src_file, const VectorOut type,
+                    dd_array<string64> &names,
+                    FrameSeq &rows);
+
+/** \brief Write parsed csv to cache */
+bool save_seq_cache(const char *src_file, const VectorOut type,
+                    const dd_array<string64> &names,
+                    const FrameSeq &rows);
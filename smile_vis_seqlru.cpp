@@ -0,0 +1,111 @@
+#include "smile_vis_seqlru.h"
+#include <algorithm>
+
+size_t LoadedSequence::bytes() const {
+  size_t compare_values = 0;
+  for (const RowMatrixXd &rows : compare) compare_values += rows.size();
+  return sizeof(double) *
+             (input.matrix().size() + ground.matrix().size() +
+              predict[0].size() + predict[1].size() + compare_values) +
+         sizeof(float) * (errors[0].size() + errors[1].size() +
+                          frame_error[0].size() + frame_error[1].size() +
+                          compare_error.size());
+}
+
+void SequenceLRU::set_budget(const size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex);
+  budget = bytes;
+  evict();
+}
+
+SequenceLRU::EntryIter SequenceLRU::find_valid(const char *in_file,
+                                               const char *g_file,
+                                               const int infer_mode) {
+  const std::map<string512, EntryIter>::iterator it =
+      index.find(string512(in_file));
+  if (it == index.end()) return entries.end();
+
+  // stale if either file changed on disk or predictions used another backend
+  // or an older model
+  const EntryIter entry = it->second;
+  FileStamp in_stamp, g_stamp;
+  if (!get_file_stamp(in_file, in_stamp) || !get_file_stamp(g_file, g_stamp) ||
+      in_stamp != entry->data->in_stamp || g_stamp != entry->data->g_stamp ||
+      entry->data->infer_mode != infer_mode ||
+      entry->data->generation < min_generation) {
+    erase(entry);
+    return entries.end();
+  }
+  return entry;
+}
+
+std::shared_ptr<const LoadedSequence> SequenceLRU::find(const char *in_file,
+                                                        const char *g_file,
+                                                        const int infer_mode) {
+  std::lock_guard<std::mutex> lock(mutex);
+  const EntryIter entry = find_valid(in_file, g_file, infer_mode);
+  if (entry == entries.end()) {
+    counters.misses++;
+    return std::shared_ptr<const LoadedSequence>();
+  }
+
+  counters.hits++;
+  entries.splice(entries.begin(), entries, entry);
+  return entry->data;
+}
+
+bool SequenceLRU::contains(const char *in_file, const char *g_file,
+                           const int infer_mode) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return find_valid(in_file, g_file, infer_mode) != entries.end();
+}
+
+void SequenceLRU::insert(const char *in_file,
+                         std::shared_ptr<const LoadedSequence> data) {
+  Entry entry;
+  entry.in_file = in_file;
+  entry.bytes = data->bytes();
+  entry.data = data;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  // finished after the model changed (checked under the lock clear() takes)
+  if (data->generation < min_generation) return;
+  const std::map<string512, EntryIter>::iterator it =
+      index.find(entry.in_file);
+  if (it != index.end()) erase(it->second);
+  if (entry.bytes > budget) return;
+
+  entries.push_front(entry);
+  index[entry.in_file] = entries.begin();
+  counters.resident_bytes += entry.bytes;
+  evict();
+}
+
+void SequenceLRU::clear(const unsigned generation) {
+  std::lock_guard<std::mutex> lock(mutex);
+  min_generation = std::max(min_generation, generation);
+  entries.clear();
+  index.clear();
+  counters.resident_bytes = 0;
+}
+
+SequenceLRU::Stats SequenceLRU::stats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats out = counters;
+  out.budget_bytes = budget;
+  out.entries = (unsigned)entries.size();
+  return out;
+}
+
+void SequenceLRU::erase(EntryIter it) {
+  counters.resident_bytes -= it->bytes;
+  index.erase(it->in_file);
+  entries.erase(it);
+}
+
+void SequenceLRU::evict() {
+  while (counters.resident_bytes > budget && !entries.empty()) {
+    erase(std::prev(entries.end()));
+    counters.evictions++;
+  }
+}
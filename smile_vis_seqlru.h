@@ -0,0 +1,102 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include "smile_vis_data.h"
+#include "smile_vis_mmap.h"
+
+/** \brief Parsed input & ground truth sequence w/ predictions of both models */
+struct LoadedSequence {
+  FrameSeq input;
+  FrameSeq ground;
+  RowMatrixXd predict[2];
+  // per frame & landmark errors of both models, & their per frame mean
+  Eigen::MatrixXf errors[2];
+  Eigen::VectorXf frame_error[2];
+  // predictions & mean landmark error (-1: none) of the comparison models
+  std::vector<RowMatrixXd> compare;
+  std::vector<float> compare_error;
+  // box around input, ground truth & predictions of all frames
+  glm::vec4 bounds = empty_bounds();
+  bool canonical = false;
+  int infer_mode = 0;
+  // model generation the predictions were made with (set by the viewer)
+  unsigned generation = 0;
+  // size/mtime of both source files, taken before parsing (a file rewritten
+  // while it was read makes the entry stale)
+  FileStamp in_stamp;
+  FileStamp g_stamp;
+
+  /** \brief Heap bytes held by the sequence */
+  size_t bytes() const;
+};
+
+/**
+ * In-memory LRU of loaded sequences
+ *
+ * Entries are keyed by input file path & validated against the size/mtime
+ * of both source files & the inference mode they were predicted with, so a
+ * changed file or backend counts as a miss. Least recently used entries are
+ * evicted once resident bytes exceed the budget. Thread safe.
+ */
+class SequenceLRU {
+ public:
+  /** \brief Hit/miss & residency counters */
+  struct Stats {
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+    unsigned long evictions = 0;
+    size_t resident_bytes = 0;
+    size_t budget_bytes = 0;
+    unsigned entries = 0;
+  };
+
+  /** \brief Set memory budget (evicts immediately if over) */
+  void set_budget(const size_t bytes);
+
+  /** \brief Get up to date entry for file pair (nullptr on miss) */
+  std::shared_ptr<const LoadedSequence> find(const char *in_file,
+                                             const char *g_file,
+                                             const int infer_mode);
+
+  /** \brief Check for up to date entry w/o touching LRU order or counters */
+  bool contains(const char *in_file, const char *g_file, const int infer_mode);
+
+  /**
+   * \brief Add/replace entry validated against the file stamps in data
+   * (skipped if larger than the whole budget or predicted w/ a generation
+   * older than the last clear())
+   */
+  void insert(const char *in_file, std::shared_ptr<const LoadedSequence> data);
+
+  /**
+   * \brief Drop all entries & refuse ones w/ an older model generation
+   * (in-flight loads of the previous model can't repopulate the cache)
+   */
+  void clear(const unsigned generation = 0);
+
+  Stats stats();
+
+ private:
+  struct Entry {
+    string512 in_file;
+    std::shared_ptr<const LoadedSequence> data;
+    size_t bytes = 0;
+  };
+  typedef std::list<Entry>::iterator EntryIter;
+
+  /** \brief Find entry that is still valid (lock must be held) */
+  EntryIter find_valid(const char *in_file, const char *g_file,
+                       const int infer_mode);
+  void erase(EntryIter it);
+  void evict();
+
+  std::mutex mutex;
+  // most recently used at the front
+  std::list<Entry> entries;
+  std::map<string512, EntryIter> index;
+  Stats counters;
+  size_t budget = (size_t)256 << 20;
+  unsigned min_generation = 0;
+};
@@ -0,0 +1,141 @@
+#include "smile_vis_stats.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+std::atomic<bool> stats_flag(true);
+
+namespace {
+// slots never move once registered (call sites keep references)
+std::deque<StatSlot> slots;
+std::mutex slots_mutex;
+
+/** \brief Complete ("X") trace event */
+struct TraceEvent {
+  const char *name;
+  unsigned tid;
+  uint64_t start_ns;
+  uint64_t dur_ns;
+};
+
+// recording is bounded so a forgotten trace can't eat all memory
+const size_t max_trace_events = (size_t)1 << 20;
+std::vector<TraceEvent> trace;
+std::atomic<bool> trace_on(false);
+uint64_t trace_origin_ns = 0;
+std::mutex trace_mutex;
+
+// small sequential ids read better in the trace viewer than native ids
+std::atomic<unsigned> next_tid(0);
+thread_local const unsigned trace_tid = next_tid++;
+
+/** \brief Raise max to val */
+void atomic_max(std::atomic<uint64_t> &max, const uint64_t val) {
+  uint64_t curr = max.load(std::memory_order_relaxed);
+  while (curr < val &&
+         !max.compare_exchange_weak(curr, val, std::memory_order_relaxed)) {
+  }
+}
+}  // namespace
+
+StatSlot &stat_slot(const char *name) {
+  std::lock_guard<std::mutex> lock(slots_mutex);
+  for (StatSlot &slot : slots) {
+    if (std::strcmp(slot.name, name) == 0) return slot;
+  }
+  slots.emplace_back(name);
+  return slots.back();
+}
+
+void set_stats_enabled(const bool flag) { stats_flag = flag; }
+
+std::vector<StatSnapshot> stats_snapshot() {
+  std::lock_guard<std::mutex> lock(slots_mutex);
+  std::vector<StatSnapshot> out(slots.size());
+  for (size_t i = 0; i < slots.size(); i++) {
+    const StatSlot &slot = slots[i];
+    StatSnapshot &snap = out[i];
+    snap.name = slot.name;
+    snap.calls = slot.calls.load(std::memory_order_relaxed);
+    snap.total_ms = slot.total_ns.load(std::memory_order_relaxed) * 1e-6;
+    snap.avg_ms = snap.calls > 0 ? snap.total_ms / snap.calls : 0.0;
+    snap.max_ms = slot.max_ns.load(std::memory_order_relaxed) * 1e-6;
+    snap.bytes = slot.bytes.load(std::memory_order_relaxed);
+  }
+  return out;
+}
+
+void stats_reset() {
+  std::lock_guard<std::mutex> lock(slots_mutex);
+  for (StatSlot &slot : slots) {
+    slot.calls = 0;
+    slot.total_ns = 0;
+    slot.max_ns = 0;
+    slot.bytes = 0;
+  }
+}
+
+void trace_start() {
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  trace.clear();
+  trace_origin_ns = stat_clock_ns();
+  trace_on = true;
+}
+
+void trace_stop() { trace_on = false; }
+
+bool trace_recording() { return trace_on; }
+
+size_t trace_events() {
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  return trace.size();
+}
+
+bool trace_save(const char *file) {
+  std::vector<TraceEvent> events;
+  uint64_t origin = 0;
+  {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    events = trace;
+    origin = trace_origin_ns;
+  }
+
+  FILE *out = std::fopen(file, "w");
+  if (!out) return false;
+
+  // timestamps & durations are in microseconds
+  std::fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (size_t i = 0; i < events.size(); i++) {
+    const TraceEvent &ev = events[i];
+    std::fprintf(out,
+                 "{\"name\":\"%s\",\"cat\":\"smile_vis\",\"ph\":\"X\","
+                 "\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                 ev.name, ev.tid,
+                 (ev.start_ns > origin ? ev.start_ns - origin : 0) * 1e-3,
+                 ev.dur_ns * 1e-3, i + 1 < events.size() ? "," : "");
+  }
+  std::fprintf(out, "]}\n");
+  return std::fclose(out) == 0;
+}
+
+uint64_t stat_clock_ns() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void stat_record(StatSlot &slot, const uint64_t start_ns,
+                 const uint64_t end_ns) {
+  const uint64_t dur = end_ns - start_ns;
+  slot.calls.fetch_add(1, std::memory_order_relaxed);
+  slot.total_ns.fetch_add(dur, std::memory_order_relaxed);
+  atomic_max(slot.max_ns, dur);
+
+  if (!trace_on.load(std::memory_order_relaxed)) return;
+  std::lock_guard<std::mutex> lock(trace_mutex);
+  if (trace.size() < max_trace_events) {
+    trace.push_back({slot.name, trace_tid, start_ns, dur});
+  }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "StringLib.h"
+
+/**
+ * Hot path timers & counters
+ *
+ * SVIS_SCOPE(name) times the enclosing scope into the named slot (calls,
+ * total & max time), SVIS_BYTES(name, n) adds to its byte counter. Each call
+ * site resolves its slot once, after that a sample is a clock read & a few
+ * relaxed atomics. Sites sharing a name share a slot.
+ *
+ * Collection is switched at runtime w/ set_stats_enabled() (1 flag check per
+ * site when off) & compiled out completely w/ -DSVIS_STATS=0. While a trace
+ * is recording every timed scope is also logged as a Chrome trace event
+ * (chrome://tracing or ui.perfetto.dev).
+ */
+#ifndef SVIS_STATS
+#define SVIS_STATS 1
+#endif
+
+/** \brief Accumulated samples of 1 named site */
+struct StatSlot {
+  const char *name = nullptr;
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> total_ns;
+  std::atomic<uint64_t> max_ns;
+  std::atomic<uint64_t> bytes;
+
+  explicit StatSlot(const char *slot_name)
+      : name(slot_name), calls(0), total_ns(0), max_ns(0), bytes(0) {}
+};
+
+/** \brief Copy of 1 slot for display */
+struct StatSnapshot {
+  string64 name;
+  uint64_t calls = 0;
+  double total_ms = 0.0;
+  double avg_ms = 0.0;
+  double max_ms = 0.0;
+  uint64_t bytes = 0;
+};
+
+/** \brief Get (or register) slot by name (reference stays valid) */
+StatSlot &stat_slot(const char *name);
+
+/** \brief Switch collection on/off at runtime */
+void set_stats_enabled(const bool flag);
+
+// runtime switch (read on every sample, set w/ set_stats_enabled)
+extern std::atomic<bool> stats_flag;
+
+inline bool stats_enabled() {
+  return stats_flag.load(std::memory_order_relaxed);
+}
+
+/** \brief Copy of every slot in registration order */
+std::vector<StatSnapshot> stats_snapshot();
+
+/** \brief Zero every slot */
+void stats_reset();
+
+/** \brief Start recording trace events (drops the previous recording) */
+void trace_start();
+
+/** \brief Stop recording (events are kept until the next start) */
+void trace_stop();
+
+bool trace_recording();
+
+/** \brief Recorded event count */
+size_t trace_events();
+
+/** \brief Write recording as Chrome trace-event JSON (false on failure) */
+bool trace_save(const char *file);
+
+/** \brief Monotonic clock in ns */
+uint64_t stat_clock_ns();
+
+/** \brief Add sample to slot (& trace if recording) */
+void stat_record(StatSlot &slot, const uint64_t start_ns,
+                 const uint64_t end_ns);
+
+/** \brief Times its lifetime into a slot */
+class ScopedStat {
+ public:
+  explicit ScopedStat(StatSlot &stat_slot)
+      : slot(stat_slot), start(stats_enabled() ? stat_clock_ns() : 0) {}
+  ~ScopedStat() {
+    if (start) stat_record(slot, start, stat_clock_ns());
+  }
+  ScopedStat(const ScopedStat &) = delete;
+  ScopedStat &operator=(const ScopedStat &) = delete;
+
+ private:
+  StatSlot &slot;
+  const uint64_t start;
+};
+
+/** \brief Add bytes to slot (if collecting) */
+inline void stat_bytes(StatSlot &slot, const uint64_t bytes) {
+  if (stats_enabled()) slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+#define SVIS_STAT_CAT2(a, b) a##b
+#define SVIS_STAT_CAT(a, b) SVIS_STAT_CAT2(a, b)
+
+#if SVIS_STATS
+#define SVIS_SCOPE(name)                                                 \
+  static StatSlot &SVIS_STAT_CAT(svis_slot_, __LINE__) = stat_slot(name); \
+  const ScopedStat SVIS_STAT_CAT(svis_scope_, __LINE__)(                  \
+      SVIS_STAT_CAT(svis_slot_, __LINE__))
+#define SVIS_BYTES(name, n)                                  \
+  do {                                                       \
+    static StatSlot &svis_bytes_slot = stat_slot(name);      \
+    stat_bytes(svis_bytes_slot, (uint64_t)(n));              \
+  } while (0)
+#else
+#define SVIS_SCOPE(name) \
+  do {                   \
+  } while (0)
+#define SVIS_BYTES(name, n) \
+  do {                      \
+  } while (0)
+#endif
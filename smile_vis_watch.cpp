@@ -0,0 +1,63 @@
+#include "smile_vis_watch.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+bool DirWatcher::add(const char *directory) {
+  for (size_t i = 0; i < dirs.size(); i++) {
+    if (dirs[i] == directory) return true;
+  }
+  if (fd < 0) fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0) return false;
+
+  // close_write: file fully written, moved_to: atomic replace via rename
+  // (no create, a new file is still empty or partial at that point)
+  const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE;
+  if (inotify_add_watch(fd, directory, mask) < 0) return false;
+  dirs.push_back(directory);
+  return true;
+}
+
+void DirWatcher::clear() {
+  // closing the descriptor drops every watch
+  if (fd >= 0) close(fd);
+  fd = -1;
+  dirs.clear();
+}
+
+bool DirWatcher::poll() {
+  if (fd < 0) return false;
+
+  alignas(struct inotify_event) char buff[4096];
+  bool changed = false;
+  for (;;) {
+    const ssize_t len = read(fd, buff, sizeof(buff));
+    if (len <= 0) break;
+    changed = true;
+  }
+  return changed;
+}
+#else
+bool DirWatcher::add(const char *directory) {
+  for (size_t i = 0; i < dirs.size(); i++) {
+    if (dirs[i] == directory) return true;
+  }
+  dirs.push_back(directory);
+  return true;
+}
+
+void DirWatcher::clear() { dirs.clear(); }
+
+bool DirWatcher::poll() {
+  // no change events, callers compare stamps once a second
+  if (dirs.empty()) return false;
+  const std::chrono::steady_clock::time_point now =
+      std::chrono::steady_clock::now();
+  if (now - last_poll < std::chrono::seconds(1)) return false;
+  last_poll = now;
+  return true;
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * Change notification for a set of directories
+ *
+ * Uses inotify on linux (files written, moved in or deleted). Other
+ * platforms report a possible change once per poll interval, so callers
+ * must confirm changes themselves (e.g. by comparing FileStamps).
+ */
+class DirWatcher {
+ public:
+  DirWatcher() {}
+  ~DirWatcher() { clear(); }
+  DirWatcher(const DirWatcher &) = delete;
+  DirWatcher &operator=(const DirWatcher &) = delete;
+
+  /** \brief Start watching directory (returns false if it can't be) */
+  bool add(const char *directory);
+
+  /** \brief Stop watching everything */
+  void clear();
+
+  /** \brief Drain pending events (non-blocking), true if anything changed */
+  bool poll();
+
+  bool empty() const { return dirs.empty(); }
+
+ private:
+  std::vector<std::string> dirs;
+#ifdef __linux__
+  int fd = -1;
+#else
+  std::chrono::steady_clock::time_point last_poll;
+#endif
+};
@@ -26,7 +26,12 @@ do
 		-- subscribe data manager
 		data_m.name = "smile_data_manager"
 		data_m.data = SController:get()		
-		data_m.data.tile = 0.5
+		data_m.data.tile = 0.05
+		-- refit orthographic view to every loaded sequence
+		data_m.data.fit_pad = 2.0
+		data_m.data.auto_fit = true
+		-- playback rate of captures w/o a time column
+		data_m.data.fps = 20.0
 		dd_register_callback(data_m.name, data_m)
 		dd_subscribe( {key = data_m.name, event = level_tag} )
 		dd_subscribe( {key = data_m.name, event = "calc_offset"} )
@@ -38,6 +43,9 @@ do
 		load_folder(PROJECT_DIR.."/smile_vis/input")
 		groundtruth_folder(PROJECT_DIR.."/smile_vis/ground_truth")
 		w_b_folders(PROJECT_DIR.."/smile_vis/weight",PROJECT_DIR.."/smile_vis/bias")
+		-- other checkpoints are evaluated in the same pass & overlaid, e.g.
+		-- SController.add_model("retrained", PROJECT_DIR.."/smile_vis/weight_new",
+		--   PROJECT_DIR.."/smile_vis/bias_new", 1.0, 0.65, 0.0)
 
 		ddLib.print( "smile_vis init called." )
 	end
@@ -2,6 +2,24 @@
 
 enum class RE_LineDot : int {
   MVP_m4x4 = 0,
-  color_v4 = 1
+  render_to_tex_b = 1,
+  send_to_back_b = 2,
+  color_v4 = 3,
+  bound_tex_smp2d = 4
+};
+
+enum class RE_Point : int {
+  MV_m4x4 = 0,
+  Proj_m4x4 = 1,
+  blend_f = 2,
+  quad_h_width_f = 3
+};
+
+enum class RE_Trajectory : int {
+  MVP_m4x4 = 0,
+  block_points_i = 1,
+  curr_frame_i = 2,
+  trail_frames_i = 3,
+  fade_color_v4 = 4
 };
 